@@ -0,0 +1,69 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace pavic {
+
+struct BufferPoolStats {
+    size_t requests = 0;        // alocações atendidas pelo pool (>= minPooledBytes)
+    size_t reused = 0;          // ... das quais com um buffer reciclado
+    double reuseRate = 0.0;     // reused / requests
+    size_t bytesInUse = 0;      // buffers entregues e ainda vivos
+    size_t bytesCached = 0;     // buffers livres guardados para reuso
+    size_t highWaterMark = 0;   // pico de bytesInUse + bytesCached (memória retida pelo pool)
+};
+
+// Pool de buffers por faixa de tamanho, instalável como alocador padrão do cv::Mat: saídas,
+// cópias com borda e intermediários dos filtros (gradientes, passes separáveis, tiles) reciclam
+// a memória dos quadros anteriores em vez de ir ao malloc a cada quadro. Cada faixa arredonda o
+// tamanho para cima em passos de 1/8 da potência de 2 (no máximo 12,5% de folga), então buffers
+// de mesmo tamanho aproximado se reaproveitam. Buffers menores que minPooledBytes vão direto ao
+// malloc. Thread-safe: os backends alocam de várias threads.
+class BufferPool : public cv::MatAllocator {
+public:
+    explicit BufferPool(size_t maxCachedBytes = 256u << 20, size_t minPooledBytes = 64u << 10);
+    ~BufferPool() override;
+
+    // Instala como alocador padrão de cv::Mat; uninstall restaura o anterior. Mats alocados pelo
+    // pool devolvem a memória a ele ao morrer, então o pool precisa viver mais que eles: use global().
+    void install();
+    void uninstall();
+    bool isInstalled() const { return installed; }
+
+    // Instância do processo, nunca destruída
+    static BufferPool& global();
+
+    void setMaxCachedBytes(size_t bytes);
+    void trim();   // libera todos os buffers livres
+    BufferPoolStats getStats() const;
+    void resetStats();
+
+    // cv::MatAllocator
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data0, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override;
+    bool allocate(cv::UMatData* u, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override;
+    void deallocate(cv::UMatData* u) const override;
+
+private:
+    static size_t bucketSize(size_t size);
+    uchar* acquire(size_t size) const;
+    void release(uchar* data, size_t size) const;
+    void evictUntil(size_t limit) const;
+
+    mutable std::mutex mutex;
+    mutable std::unordered_map<size_t, std::vector<uchar*>> freeLists;  // capacidade -> buffers livres
+    mutable BufferPoolStats stats;
+    size_t maxCached;
+    size_t minPooled;
+    cv::MatAllocator* previous = nullptr;
+    bool installed = false;
+};
+
+} // namespace pavic
+
+#endif // BUFFER_POOL_H
@@ -25,6 +25,20 @@ cv::Mat threshold(const cv::Mat& input, int thresholdValue = 128);
 cv::Mat median(const cv::Mat& input, int kernelSize = 5);
 cv::Mat bilateral(const cv::Mat& input, int d = 9, double sigmaColor = 75, double sigmaSpace = 75);
 
+// Saída como parâmetro: output é reaproveitado quando tamanho e tipo já batem e pode ser a própria entrada
+void grayscale(const cv::Mat& input, cv::Mat& output);
+void blur(const cv::Mat& input, cv::Mat& output, int kernelSize = 5);
+void gaussianBlur(const cv::Mat& input, cv::Mat& output, int kernelSize = 5);
+void sobel(const cv::Mat& input, cv::Mat& output);
+void canny(const cv::Mat& input, cv::Mat& output, double threshold1 = 50, double threshold2 = 150);
+void sharpen(const cv::Mat& input, cv::Mat& output);
+void emboss(const cv::Mat& input, cv::Mat& output);
+void negative(const cv::Mat& input, cv::Mat& output);
+void sepia(const cv::Mat& input, cv::Mat& output);
+void threshold(const cv::Mat& input, cv::Mat& output, int thresholdValue = 128);
+void median(const cv::Mat& input, cv::Mat& output, int kernelSize = 5);
+void bilateral(const cv::Mat& input, cv::Mat& output, int d = 9, double sigmaColor = 75, double sigmaSpace = 75);
+
 } // namespace cuda
 } // namespace pavic
 
@@ -0,0 +1,80 @@
+#ifndef CONVOLUTION_KERNELS_H
+#define CONVOLUTION_KERNELS_H
+
+#include <opencv2/opencv.hpp>
+#include <utility>
+
+namespace pavic {
+namespace utils {
+
+// Kernels embutidos com coeficientes inteiros conhecidos em tempo de compilação.
+// Com tamanho e pesos constantes o compilador desenrola os laços e elimina os taps nulos.
+struct SharpenKernel3 {
+    static constexpr int size = 3;
+    static constexpr int weights[9] = {
+         0, -1,  0,
+        -1,  5, -1,
+         0, -1,  0};
+    constexpr int operator[](int i) const { return weights[i]; }
+};
+
+struct EmbossKernel3 {
+    static constexpr int size = 3;
+    static constexpr int weights[9] = {
+        -2, -1, 0,
+        -1,  1, 1,
+         0,  1, 2};
+    constexpr int operator[](int i) const { return weights[i]; }
+};
+
+struct SobelXKernel3 {
+    static constexpr int size = 3;
+    static constexpr int weights[9] = {
+        -1, 0, 1,
+        -2, 0, 2,
+        -1, 0, 1};
+    constexpr int operator[](int i) const { return weights[i]; }
+};
+
+struct SobelYKernel3 {
+    static constexpr int size = 3;
+    static constexpr int weights[9] = {
+        -1, -2, -1,
+         0,  0,  0,
+         1,  2,  1};
+    constexpr int operator[](int i) const { return weights[i]; }
+};
+
+// Convolução K x K com CN canais sobre as linhas [rowStart, rowEnd). "padded" tem borda K/2.
+// W é um kernel embutido (pesos constexpr) ou um ponteiro para K*K pesos em tempo de execução;
+// store converte o acumulador para uchar.
+template <int K, int CN, typename W, typename Store>
+inline void convolveRowsFixedSize(const cv::Mat& padded, cv::Mat& output, W weights,
+                                  int rowStart, int rowEnd, Store store) {
+    using Acc = decltype(std::declval<W>()[0] * 1);
+    for (int i = rowStart; i < rowEnd; i++) {
+        const uchar* rows[K];
+        for (int ki = 0; ki < K; ki++) rows[ki] = padded.ptr<uchar>(i + ki);
+        uchar* dst = output.ptr<uchar>(i);
+        for (int j = 0; j < output.cols; j++) {
+            for (int c = 0; c < CN; c++) {
+                Acc sum = 0;
+                for (int ki = 0; ki < K; ki++)
+                    for (int kj = 0; kj < K; kj++)
+                        sum += rows[ki][(j + kj) * CN + c] * weights[ki * K + kj];
+                dst[j * CN + c] = store(sum);
+            }
+        }
+    }
+}
+
+template <typename Kernel, int CN>
+inline void convolveBuiltinRows(const cv::Mat& padded, cv::Mat& output, int rowStart, int rowEnd) {
+    convolveRowsFixedSize<Kernel::size, CN>(padded, output, Kernel(), rowStart, rowEnd,
+                                            [](int v) { return cv::saturate_cast<uchar>(v); });
+}
+
+} // namespace utils
+} // namespace pavic
+
+#endif // CONVOLUTION_KERNELS_H
@@ -2,10 +2,36 @@
 #define FILTER_UTILS_H
 
 #include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
 
 namespace pavic {
+
+// Precisão aritmética de convolução, conversões de cor e bilateral
+enum class Precision {
+    DOUBLE,       // legado: pesos e acumulação em double
+    FLOAT32,      // pesos e acumulação em float
+    FIXED_POINT   // pesos inteiros Q14/Q15 e acumulação inteira (bit-exato em qualquer plataforma)
+};
+
+// Norma da magnitude do gradiente (Sobel)
+enum class GradientNorm {
+    L2,     // sqrt(gx² + gy²), truncada
+    L1,     // |gx| + |gy|
+    FAST    // max + 3/8 min: aproxima L2 com erro de até ~7%, só com inteiros
+};
+
 namespace utils {
 
+std::string getPrecisionName(Precision precision);
+
+// Ponto fixo Q14 (coeficiente * 16384) dos pesos de convolução e das matrizes de cor (ColorMatrix)
+constexpr int kFixedShift = 14;
+
 // Kernels de convolução pré-definidos
 cv::Mat getGaussianKernel(int size, double sigma = 0);
 cv::Mat getSharpenKernel();
@@ -14,6 +40,237 @@ cv::Mat getSobelKernelX();
 cv::Mat getSobelKernelY();
 cv::Mat getBoxBlurKernel(int size);
 
+// Kernels 1D (coeficientes) para convolução separável: K taps por passe em vez de K×K
+std::vector<double> getGaussianKernel1D(int size, double sigma = 0);
+std::vector<double> getBoxBlurKernel1D(int size);
+// Sigma padrão de um kernel gaussiano size x size (mesma regra do OpenCV)
+double getGaussianSigma(int size);
+
+// Gaussiana recursiva (IIR de Young–van Vliet, 3ª ordem): passe causal + anticausal por eixo,
+// custo por pixel constante para qualquer sigma. Aproxima o kernel denso (diferença de poucos níveis).
+struct RecursiveGaussianCoeffs {
+    float b = 0;                  // ganho de entrada (normaliza a soma para 1)
+    float a1 = 0, a2 = 0, a3 = 0; // realimentação
+    float m[3][3] = {};           // estado inicial do passe anticausal (borda replicada, Triggs–Sdika)
+};
+RecursiveGaussianCoeffs makeRecursiveGaussianCoeffs(double sigma);
+// gaussianBlur usa a versão recursiva para kernels maiores que o limiar (padrão 15)
+void setRecursiveGaussianThreshold(int kernelSize);
+int getRecursiveGaussianThreshold();
+bool useRecursiveGaussian(int kernelSize);
+
+// Núcleos por faixa de linhas [rowStart, rowEnd) compartilhados pelos backends de CPU.
+// Cada backend decide como dividir as faixas; a aritmética depende só da precisão.
+
+// Convolução 2D: "padded" já tem a borda de kernel.rows/2 x kernel.cols/2.
+// Kernels quadrados 3x3, 5x5 e 7x7 com 1 ou 3 canais usam laços de tamanho fixo (ConvolutionKernels.h).
+void convolveRows(const cv::Mat& padded, cv::Mat& output, const cv::Mat& kernel,
+                  int rowStart, int rowEnd, Precision precision);
+
+// Kernels embutidos (coeficientes inteiros: resultado exato em qualquer precisão)
+enum class BuiltinKernel { SHARPEN, EMBOSS, SOBEL_X, SOBEL_Y };
+void convolveRows(const cv::Mat& padded, cv::Mat& output, BuiltinKernel kernel, int rowStart, int rowEnd);
+
+// Convolução separável: o intermediário tem profundidade separableBufferDepth(precision)
+int separableBufferDepth(Precision precision);
+void separableRowPass(const cv::Mat& paddedX, cv::Mat& temp, const std::vector<double>& kernelX,
+                      int rowStart, int rowEnd, Precision precision);
+void separableColumnPass(const cv::Mat& paddedY, cv::Mat& output, const std::vector<double>& kernelY,
+                         int rowStart, int rowEnd, Precision precision);
+
+// Instâncias de colorMatrixRows (abaixo) com as matrizes de cinza e sépia
+void grayscaleRows(const cv::Mat& input, cv::Mat& output, int rowStart, int rowEnd, Precision precision);
+void sepiaRows(const cv::Mat& input, cv::Mat& output, int rowStart, int rowEnd, Precision precision);
+
+// Operação pontual sobre valores de 8 bits (cada canal independente) como tabela de 256 entradas.
+// Uma sequência de operações pontuais se compõe numa única tabela (composeLut) e roda em uma passada.
+struct PointwiseLut {
+    uchar table[256];
+};
+
+template <typename F>
+inline PointwiseLut makeLut(F f) {
+    PointwiseLut lut;
+    for (int v = 0; v < 256; v++) lut.table[v] = cv::saturate_cast<uchar>(f(v));
+    return lut;
+}
+PointwiseLut makeIdentityLut();
+PointwiseLut makeNegativeLut();                             // 255 - v
+PointwiseLut makeThresholdLut(int thresholdValue);          // v > t ? 255 : 0
+PointwiseLut makeBiasLut(int offset);                       // v + offset, saturado
+PointwiseLut makeContrastLut(double alpha, double beta);    // alpha * v + beta, arredondado e saturado
+PointwiseLut makeGammaLut(double gamma);                    // 255 * (v / 255)^gamma
+// Aplica first e depois second: tabela de second(first(v))
+PointwiseLut composeLut(const PointwiseLut& first, const PointwiseLut& second);
+// output com o tamanho e o tipo de input; pode ser a própria input (in-place)
+void applyLutRows(const cv::Mat& input, cv::Mat& output, const PointwiseLut& lut, int rowStart, int rowEnd);
+
+// Transformação de cor linear por pixel BGR: saída[c] = m[c][0] * r + m[c][1] * g + m[c][2] * b,
+// truncada e saturada. outChannels = 1 (cinza) ou 3 (linhas na ordem B, G, R da saída).
+// Os coeficientes ficam em double, float e Q14, um conjunto por precisão.
+struct ColorMatrix {
+    int outChannels = 3;
+    double coeffs[3][3] = {};
+    float coeffsF[3][3] = {};
+    int fixed[3][3] = {};
+    bool inRange = false;   // coeficientes >= 0 e soma <= 1 por linha: saída sempre em [0, 255], sem saturação
+};
+ColorMatrix makeColorMatrix(const double (&coeffs)[3][3], int outChannels = 3);
+ColorMatrix makeGrayscaleMatrix();     // Y = 0.299 r + 0.587 g + 0.114 b
+ColorMatrix makeSepiaMatrix();
+ColorMatrix makeChannelSwapMatrix();   // BGR <-> RGB
+// input CV_8UC3, output CV_8UC(outChannels). lut (opcional) é aplicada a cada byte de saída na mesma
+// passada: cinza + limiar lê a imagem colorida uma vez e grava só o resultado final.
+void colorMatrixRows(const cv::Mat& input, cv::Mat& output, const ColorMatrix& matrix,
+                     int rowStart, int rowEnd, Precision precision, const PointwiseLut* lut = nullptr);
+
+// Pesos espaciais (d x d) e de cor (por diferença 0..255) do bilateral, calculados uma vez
+struct BilateralWeights {
+    int d = 0;
+    Precision precision = Precision::DOUBLE;
+    std::vector<double> spatial, color;
+    std::vector<float> spatialF, colorF;
+    std::vector<int> spatialQ, colorQ;    // Q15
+};
+BilateralWeights makeBilateralWeights(int d, double sigmaColor, double sigmaSpace, Precision precision);
+void bilateralRows(const cv::Mat& padded, cv::Mat& output, const BilateralWeights& weights,
+                   int rowStart, int rowEnd);
+
+// Gaussiana recursiva: linhas de input (8 bits) -> temp (CV_32F, mesmos canais);
+// depois colunas de elementos [colStart, colEnd) (coluna * canais + canal) de temp -> output.
+// O passe vertical reaproveita temp como buffer do passe causal.
+void recursiveGaussianRowPass(const cv::Mat& input, cv::Mat& temp, const RecursiveGaussianCoeffs& coeffs,
+                              int rowStart, int rowEnd);
+void recursiveGaussianColumnPass(cv::Mat& temp, cv::Mat& output, const RecursiveGaussianCoeffs& coeffs,
+                                 int colStart, int colEnd);
+
+// Mediana K x K por canal (elemento central da janela ordenada).
+// 3x3 e 5x5 usam uma rede de seleção min/max vetorizada; os demais tamanhos, histogramas deslizantes.
+void medianRows(const cv::Mat& padded, cv::Mat& output, int kernelSize, int rowStart, int rowEnd);
+
+// Magnitude de gradientes inteiros na norma escolhida
+inline int gradientMagnitude(int gx, int gy, GradientNorm norm) {
+    int ax = std::abs(gx), ay = std::abs(gy);
+    switch (norm) {
+        case GradientNorm::L1: return ax + ay;
+        case GradientNorm::FAST: {
+            int hi = ax > ay ? ax : ay, lo = ax + ay - hi;
+            return hi + ((3 * lo) >> 3);
+        }
+        default: return static_cast<int>(std::sqrt(static_cast<float>(gx * gx + gy * gy)));
+    }
+}
+
+// Sobel fundido: lê a vizinhança 3x3 de "gray" (borda replicada) uma vez, com gx e gy em int16,
+// e grava a magnitude saturada em output (CV_8UC1)
+void sobelRows(const cv::Mat& gray, cv::Mat& output, GradientNorm norm, int rowStart, int rowEnd);
+
+// Gradiente do Canny compactado em um uint16 por pixel: (magnitude L2 truncada << 2) | setor.
+// O setor da direção sai de comparações inteiras (sem atan2): 0 = horizontal, 1 = diagonal "\",
+// 2 = vertical, 3 = diagonal "/", comparando |gy| com tan(22,5°)|gx| e tan(67,5°)|gx| em Q15.
+// gx e gy são os Sobel 3x3 em int16 (|g| <= 1020, sem saturação), então a magnitude cabe em 14 bits.
+inline int cannySector(int gx, int gy) {
+    const int tg22 = 13573;   // tan(22,5°) * 2^15; tan(67,5°) = tan(22,5°) + 2
+    int ax = std::abs(gx), ay = std::abs(gy) << 15;
+    int tg22x = ax * tg22;
+    if (ay < tg22x) return 0;
+    if (ay > tg22x + (ax << 16)) return 2;
+    return (gx ^ gy) < 0 ? 3 : 1;
+}
+
+inline uint16_t packCannyGradient(int magnitude, int gx, int gy) {
+    return static_cast<uint16_t>((magnitude << 2) | cannySector(gx, gy));
+}
+
+// Sobel de "gray" (borda replicada) -> gradient (CV_16UC1 no formato acima)
+void cannyGradientRows(const cv::Mat& gray, cv::Mat& gradient, int rowStart, int rowEnd);
+// Supressão de não-máximos no setor de cada pixel + limiares duplos -> edges (CV_8UC1):
+// 255 = forte, 128 = fraca, 0 = fundo; a moldura de 1 pixel fica em 0
+void cannyNmsRows(const cv::Mat& gradient, cv::Mat& edges, double threshold1, double threshold2,
+                  int rowStart, int rowEnd);
+// Canny fundido até a NMS: cinza -> Gaussiana 5x5 -> Sobel -> NMS + limiares em fluxo, com anéis de
+// poucas linhas por estágio; só as linhas [rowStart, rowEnd) de edges são escritas. Cada faixa
+// recalcula um halo de 4 linhas acima e abaixo, então faixas diferentes podem rodar em paralelo.
+// input em 8 bits com 1 ou 3 canais; resultado idêntico ao pipeline materializado (precisão DOUBLE).
+void cannyFusedRows(const cv::Mat& input, cv::Mat& edges, double threshold1, double threshold2,
+                    int rowStart, int rowEnd);
+
+// Histerese do Canny sobre o mapa da NMS (255 = forte, 128 = fraca, 0 = fundo): toda borda fraca
+// ligada a uma forte por um caminho de candidatos em 8-vizinhança vira 255, o resto vira 0,
+// independente da ordem de varredura. Union-find com um rótulo por pixel ("labels", edges.total()):
+// faixas de linhas são rotuladas em paralelo, as fronteiras entre faixas unidas em série
+// (hysteresisMergeRow na primeira linha de cada faixa) e a saída resolvida em paralelo.
+void hysteresisLabelRows(const cv::Mat& edges, std::vector<int>& labels, int rowStart, int rowEnd);
+void hysteresisMergeRow(std::vector<int>& labels, int cols, int row);
+void hysteresisResolveRows(cv::Mat& edges, const std::vector<int>& labels, int rowStart, int rowEnd);
+void hysteresis(cv::Mat& edges);   // versão sequencial (uma faixa)
+
+// Execução em blocos 2D (tiles) com halo para filtros de vizinhança.
+// Os núcleos acima recebem a janela (tile + halo) de um tile e a ROI correspondente da saída,
+// de modo que as linhas verticais do kernel sejam reaproveitadas na cache.
+struct TileSize {
+    int rows = 0;   // 0 = automático (derivado da cache L2)
+    int cols = 0;
+};
+void setTileSize(TileSize size);
+TileSize getTileSize();
+size_t getCacheSizeBytes();   // L2 por núcleo; 256 KiB se não for possível detectar
+// Tamanho efetivo: o configurado ou o que faz a janela de entrada e a saída caberem em metade da L2
+TileSize resolveTileSize(cv::Size imageSize, size_t bytesPerPixel, int haloY, int haloX);
+// Borda virtual (sem copyMakeBorder da imagem inteira): os tiles nunca cruzam a fronteira entre
+// o interior, onde a janela com halo cabe na imagem, e as faixas de borda de largura halo
+std::vector<cv::Rect> makeTiles(cv::Size imageSize, TileSize tile, int haloY, int haloX);
+// Janela (tile + halo) de "input": visão direta no interior; nas faixas de borda,
+// cópia local pequena com BORDER_REPLICATE
+cv::Mat sourceWindow(const cv::Mat& input, const cv::Rect& tile, int haloY, int haloX);
+// Entrada que sobrevive à escrita em "output": cópia quando os dois dividem o buffer (filtro de
+// vizinhança chamado in-place), a própria entrada caso contrário
+cv::Mat detachedInput(const cv::Mat& input, const cv::Mat& output);
+
+// Imagem integral (summed-area table), (rows + 1) x (cols + 1) com os mesmos canais e uma linha/coluna
+// de zeros no início: a soma da janela [y0, y1) x [x0, x1) sai de 4 leituras (windowSum).
+// sdepth = CV_32S: acumulação módulo 2^32, exata para qualquer janela cuja soma caiba em 31 bits;
+// sdepth = CV_64F: 64 bits, exata até 2^53. sqsum (CV_64F) recebe a soma dos quadrados.
+// Construção paralela (OpenMP): prefixo por linha, depois prefixo vertical em faixas de colunas.
+void integral(const cv::Mat& input, cv::Mat& sum, int sdepth = CV_32S);
+void integral(const cv::Mat& input, cv::Mat& sum, cv::Mat& sqsum, int sdepth = CV_32S);
+
+template <typename T>
+inline T windowSum(const cv::Mat& sum, int y0, int x0, int y1, int x1, int c) {
+    int cn = sum.channels();
+    const T* top = sum.ptr<T>(y0);
+    const T* bottom = sum.ptr<T>(y1);
+    return bottom[x1 * cn + c] - bottom[x0 * cn + c] - top[x1 * cn + c] + top[x0 * cn + c];
+}
+
+template <>
+inline int windowSum<int>(const cv::Mat& sum, int y0, int x0, int y1, int x1, int c) {
+    // Aritmética sem sinal: o estouro dos totais se cancela na diferença
+    int cn = sum.channels();
+    const uint32_t* top = reinterpret_cast<const uint32_t*>(sum.ptr<int>(y0));
+    const uint32_t* bottom = reinterpret_cast<const uint32_t*>(sum.ptr<int>(y1));
+    return static_cast<int>(bottom[x1 * cn + c] - bottom[x0 * cn + c] - top[x1 * cn + c] + top[x0 * cn + c]);
+}
+
+// Consultas O(1) por pixel sobre a imagem integral (janelas recortadas na borda da imagem)
+// Box blur de raio variável: radius (CV_8UC1, mesmo tamanho) dá o raio da janela de cada pixel
+cv::Mat variableBoxBlur(const cv::Mat& input, const cv::Mat& radius);
+// Média e variância locais numa janela kernelSize x kernelSize; saídas CV_32F com os canais de input
+void localMeanVariance(const cv::Mat& input, int kernelSize, cv::Mat& mean, cv::Mat& variance);
+
+// Layout planar (SoA): um plano CV_8UC1 por canal, em vez de BGR BGR ... intercalado.
+// Nos planos os núcleos por canal rodam com passo 1 (sem ramos por canal); a conversão
+// deve ser feita uma vez por sequência de filtros, não a cada filtro.
+struct PlanarImage {
+    std::vector<cv::Mat> planes;
+    
+    bool empty() const { return planes.empty() || planes[0].empty(); }
+    int channels() const { return static_cast<int>(planes.size()); }
+    cv::Size size() const { return empty() ? cv::Size() : planes[0].size(); }
+};
+PlanarImage toPlanar(const cv::Mat& input);
+cv::Mat fromPlanar(const PlanarImage& planar);
+
 // Funções utilitárias
 cv::Mat padImage(const cv::Mat& input, int padding, int borderType = cv::BORDER_REPLICATE);
 void clampValues(cv::Mat& image);
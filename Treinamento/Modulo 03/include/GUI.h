@@ -6,6 +6,7 @@
 #include <vector>
 #include <functional>
 #include "ImageProcessor.h"
+#include "IncrementalProcessor.h"
 #include "WebcamCapture.h"
 
 namespace pavic {
@@ -45,6 +46,7 @@ private:
 
     // Componentes
     ImageProcessor processor;
+    IncrementalProcessor incremental;  // webcam: só os tiles que mudaram são recalculados
     std::vector<Button> filterButtons;
     std::vector<Button> processingButtons;
     std::vector<Button> controlButtons;
@@ -5,6 +5,9 @@
 #include <string>
 #include <functional>
 #include <chrono>
+#include <vector>
+#include "FilterUtils.h"
+#include "ResultCache.h"
 
 namespace pavic {
 
@@ -13,7 +16,9 @@ enum class ProcessingType {
     SEQUENTIAL,
     PARALLEL,
     MULTITHREAD,
-    CUDA
+    CUDA,
+    SIMD,               // SSE4.1/AVX2 em uma thread
+    SIMD_MULTITHREAD    // SSE4.1/AVX2 + threads
 };
 
 // Enum para tipos de filtro
@@ -32,6 +37,13 @@ enum class FilterType {
     BILATERAL
 };
 
+// Saída das variantes com região de interesse (ROI)
+enum class RoiOutput {
+    CROP,       // só a região filtrada, do tamanho da ROI
+    COMPOSE,    // cópia da imagem inteira com a região filtrada (custa uma cópia da imagem)
+    IN_PLACE    // região gravada de volta na imagem carregada (só applyFilterROI); o resto fica intocado
+};
+
 // Estrutura para resultado do processamento
 struct ProcessingResult {
     cv::Mat image;
@@ -40,6 +52,35 @@ struct ProcessingResult {
     FilterType filterType;
     bool success;
     std::string errorMessage;
+    bool fromCache = false;  // imagem devolvida pela cache de resultados, sem reprocessar
+};
+
+// Passo de uma cadeia de filtros; cada filtro usa só os parâmetros que lhe dizem respeito
+struct FilterStep {
+    FilterType filter;
+    int kernelSize = 5;                      // Blur, Gaussian Blur, Median
+    int thresholdValue = 128;                // Threshold
+    double threshold1 = 50, threshold2 = 150;  // Canny
+    GradientNorm norm = GradientNorm::L2;    // Sobel
+    int d = 9;                               // Bilateral
+    double sigmaColor = 75, sigmaSpace = 75;
+};
+
+// Tempo de um estágio da cadeia: os passos [firstStep, lastStep] rodaram juntos (fundidos)
+struct StageTiming {
+    std::string name;       // filtros do estágio unidos por "+", ex.: "Blur+Sharpen+Threshold"
+    size_t firstStep = 0;
+    size_t lastStep = 0;
+    double executionTimeMs = 0;
+};
+
+struct PipelineResult {
+    cv::Mat image;
+    double executionTimeMs = 0;     // total da cadeia
+    ProcessingType processingType = ProcessingType::SEQUENTIAL;
+    std::vector<StageTiming> stages;
+    bool success = false;
+    std::string errorMessage;
 };
 
 // Classe principal de processamento de imagens
@@ -57,19 +98,88 @@ public:
     cv::Mat getOriginalImage() const;
     cv::Mat getProcessedImage() const;
 
-    // Aplicar filtro
-    ProcessingResult applyFilter(FilterType filter, ProcessingType processing);
+    // Aplicar filtro. Com a cache de resultados ligada e useCache = true, o resultado de uma
+    // combinação já vista (mesmo conteúdo, filtro, parâmetros, backend e precisão) volta sem
+    // reprocessar; o tempo medido passa a ser o da consulta e fromCache vem true.
+    ProcessingResult applyFilter(FilterType filter, ProcessingType processing, bool useCache = true);
     
-    // Processar imagem de webcam
-    ProcessingResult processFrame(const cv::Mat& frame, FilterType filter, ProcessingType processing);
+    // Processar imagem de webcam (o hash do frame é recalculado a cada chamada)
+    ProcessingResult processFrame(const cv::Mat& frame, FilterType filter, ProcessingType processing,
+                                  bool useCache = true);
+    // Versão para o laço de vídeo: o resultado é escrito em output, reaproveitado quando tamanho e
+    // tipo já batem (output pode ser o próprio frame); result.image compartilha esse buffer. Não
+    // passa pela cache, que guardaria uma imagem sobrescrita no quadro seguinte.
+    ProcessingResult processFrame(const cv::Mat& frame, FilterType filter, ProcessingType processing, cv::Mat& output);
+
+    // Filtro só na região de interesse: lê a ROI mais o halo do filtro (recortados na imagem) e
+    // escreve só a ROI, então o custo é o de uma imagem do tamanho da ROI. O resultado na ROI é
+    // idêntico ao do filtro na imagem inteira, exceto Canny (a histerese só segue bordas dentro da
+    // janela) e Gaussiana recursiva (halo truncado em 4 sigma). Filtros que mudam o número de canais
+    // são convertidos para os canais da entrada em COMPOSE/IN_PLACE. Não passam pela cache.
+    // IN_PLACE só vale em applyFilterROI, que é dona da imagem carregada; processFrameROI recebe o
+    // frame como const e devolve erro com IN_PLACE.
+    ProcessingResult applyFilterROI(FilterType filter, ProcessingType processing, const cv::Rect& roi,
+                                    RoiOutput output = RoiOutput::CROP);
+    ProcessingResult processFrameROI(const cv::Mat& frame, const cv::Rect& roi, FilterType filter,
+                                     ProcessingType processing, RoiOutput output = RoiOutput::CROP);
+
+    // Cache LRU de resultados de applyFilter/processFrame, limitada a budgetBytes (0, o padrão,
+    // desliga e libera). As imagens da cache são compartilhadas com os resultados: clone() antes
+    // de escrever num resultado. Medições de tempo devem passar useCache = false.
+    void setResultCacheBudget(size_t budgetBytes) { resultCache.setBudget(budgetBytes); }
+    size_t getResultCacheBudget() const { return resultCache.getBudget(); }
+    ResultCacheStats getResultCacheStats() const { return resultCache.getStats(); }
+    void clearResultCache() { resultCache.clear(); }
+
+    // Cadeia de filtros em ordem. Com fuse = true, passos pontuais vizinhos viram uma matriz de cor
+    // e/ou uma LUT, e passos locais (pontuais e de vizinhança) consecutivos rodam tile a tile com o
+    // halo somado: cada tile atravessa a cadeia inteira enquanto está na cache e os estágios se
+    // alternam entre dois buffers internos reaproveitados a cada chamada. Canny, Gaussiana
+    // recursiva e o backend CUDA rodam como estágios isolados. Com fuse = false cada passo roda como
+    // em applyFilter e tem seu próprio tempo. O resultado é idêntico nos dois modos.
+    // Com planar = true, estágios consecutivos que não misturam canais rodam plano a plano: a imagem
+    // é separada (utils::toPlanar) uma vez no início da sequência e reintercalada no fim.
+    // A imagem devolvida pode compartilhar um buffer interno: clone() para guardá-la entre chamadas.
+    PipelineResult applyPipeline(const std::vector<FilterStep>& steps, ProcessingType processing, bool fuse = true,
+                                 bool planar = false);
+    PipelineResult processFramePipeline(const cv::Mat& frame, const std::vector<FilterStep>& steps,
+                                        ProcessingType processing, bool fuse = true, bool planar = false);
+
+    // Precisão usada pelos backends de CPU (Sequential, Parallel, Multithread)
+    void setPrecision(Precision p) { precision = p; }
+    Precision getPrecision() const { return precision; }
+
+    // Layout planar: um passo sobre uma imagem já separada (utils::toPlanar), com os parâmetros do
+    // FilterStep. Filtros por canal rodam plano a plano (resultado idêntico ao intercalado); os que
+    // misturam canais (Grayscale, Sepia, Sobel, Canny, Threshold) reintercalam a cada chamada.
+    // Para uma cadeia, prefira applyPipeline com planar = true.
+    static bool isPerChannelFilter(FilterType filter);
+    static utils::PlanarImage applyFilterPlanar(const utils::PlanarImage& input, const FilterStep& step,
+                                                ProcessingType processing, Precision precision = Precision::DOUBLE);
+
+    // Raio da vizinhança que o filtro lê em volta de cada pixel; -1 quando a saída depende da
+    // imagem inteira (Canny, Gaussiana recursiva)
+    static int getFilterHalo(FilterType filter);
 
     // Obter nome do filtro/processamento
     static std::string getFilterName(FilterType filter);
     static std::string getProcessingName(ProcessingType processing);
 
 private:
+    PipelineResult runPipeline(const cv::Mat& input, const std::vector<FilterStep>& steps,
+                               ProcessingType processing, bool fuse, bool planar);
+    ProcessingResult runFilter(const cv::Mat& input, uint64_t* contentHash, bool* contentHashValid, FilterType filter,
+                               ProcessingType processing, bool useCache);
+    ProcessingResult runFilterROI(const cv::Mat& input, const cv::Rect& roi, FilterType filter,
+                                  ProcessingType processing, RoiOutput output);
+
     cv::Mat originalImage;
     cv::Mat processedImage;
+    Precision precision = Precision::DOUBLE;
+    cv::Mat pipelineBuffers[2];  // ping-pong entre os estágios fundidos da cadeia
+    ResultCache resultCache;
+    uint64_t originalHash = 0;   // hash de originalImage, calculado na primeira consulta à cache
+    bool originalHashValid = false;
 };
 
 } // namespace pavic
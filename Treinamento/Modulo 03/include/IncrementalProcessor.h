@@ -0,0 +1,58 @@
+#ifndef INCREMENTAL_PROCESSOR_H
+#define INCREMENTAL_PROCESSOR_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+#include "ImageProcessor.h"
+
+namespace pavic {
+
+struct IncrementalStats {
+    int totalTiles = 0;
+    int changedTiles = 0;         // tiles cuja entrada mudou acima do limiar
+    int recomputedTiles = 0;      // mudados + vizinhos alcançados pelo halo do filtro
+    double recomputeRatio = 1.0;  // recomputedTiles / totalTiles
+};
+
+// Processamento incremental de vídeo: o quadro é dividido em tiles, cada tile é comparado (SAD)
+// com a referência do quadro anterior e só os tiles mudados, mais os vizinhos que o halo do
+// filtro alcança, são recalculados; os demais reaproveitam a saída anterior. Troca de filtro,
+// backend, tamanho ou tipo do quadro recalcula tudo. Filtros sem halo finito (Canny, Gaussiana
+// recursiva) recalculam o quadro inteiro quando algum tile muda.
+class IncrementalProcessor {
+public:
+    // threshold: diferença absoluta média por byte acima da qual um tile conta como mudado.
+    // Com 0 qualquer mudança conta e a saída é idêntica à do quadro inteiro; acima de 0 o ruído do
+    // sensor é ignorado e um tile só é recalculado quando se afasta da última referência usada.
+    explicit IncrementalProcessor(int tileSize = 64, double threshold = 2.0);
+
+    void setTileSize(int size);
+    int getTileSize() const { return tileSize; }
+    void setThreshold(double meanAbsDiff) { threshold = meanAbsDiff; }
+    double getThreshold() const { return threshold; }
+    void setPrecision(Precision p);
+
+    // A imagem devolvida é o buffer interno de saída, atualizado no próximo quadro: clone() para guardá-la
+    ProcessingResult processFrame(const cv::Mat& frame, FilterType filter, ProcessingType processing);
+    const IncrementalStats& getStats() const { return stats; }
+
+    // Descarta a referência: o próximo quadro é processado inteiro
+    void reset();
+
+private:
+    ImageProcessor processor;
+    cv::Mat reference;    // entrada de referência de cada tile
+    cv::Mat output;
+    FilterType lastFilter = FilterType::GRAYSCALE;
+    ProcessingType lastProcessing = ProcessingType::SEQUENTIAL;
+    bool valid = false;
+    int tileSize;
+    double threshold;
+    IncrementalStats stats;
+    std::vector<unsigned char> changed;
+    std::vector<unsigned char> recompute;
+};
+
+} // namespace pavic
+
+#endif // INCREMENTAL_PROCESSOR_H
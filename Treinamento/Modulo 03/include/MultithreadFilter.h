@@ -4,23 +4,64 @@
 #include <opencv2/opencv.hpp>
 #include <thread>
 #include <vector>
+#include <functional>
+#include "FilterUtils.h"
 
 namespace pavic {
 namespace multithread {
 
 // Filtros multithread usando std::thread
-cv::Mat grayscale(const cv::Mat& input, int numThreads = 0);
-cv::Mat blur(const cv::Mat& input, int kernelSize = 5, int numThreads = 0);
-cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize = 5, int numThreads = 0);
-cv::Mat sobel(const cv::Mat& input, int numThreads = 0);
+// precision: aritmética de convolução/cor/bilateral (DOUBLE = comportamento original)
+cv::Mat grayscale(const cv::Mat& input, int numThreads = 0, Precision precision = Precision::DOUBLE);
+cv::Mat blur(const cv::Mat& input, int kernelSize = 5, int numThreads = 0, Precision precision = Precision::DOUBLE);
+cv::Mat boxBlur(const cv::Mat& input, int kernelSize = 5, int numThreads = 0);  // somas deslizantes, O(1) por pixel
+cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize = 5, int numThreads = 0, Precision precision = Precision::DOUBLE);
+cv::Mat recursiveGaussianBlur(const cv::Mat& input, double sigma, int numThreads = 0);  // IIR, O(1) por pixel em sigma
+cv::Mat sobel(const cv::Mat& input, int numThreads = 0, GradientNorm norm = GradientNorm::L2);
 cv::Mat canny(const cv::Mat& input, double threshold1 = 50, double threshold2 = 150, int numThreads = 0);
-cv::Mat sharpen(const cv::Mat& input, int numThreads = 0);
+cv::Mat sharpen(const cv::Mat& input, int numThreads = 0);  // kernels embutidos: inteiros, exatos em qualquer precisão
 cv::Mat emboss(const cv::Mat& input, int numThreads = 0);
 cv::Mat negative(const cv::Mat& input, int numThreads = 0);
-cv::Mat sepia(const cv::Mat& input, int numThreads = 0);
+cv::Mat sepia(const cv::Mat& input, int numThreads = 0, Precision precision = Precision::DOUBLE);
 cv::Mat threshold(const cv::Mat& input, int thresholdValue = 128, int numThreads = 0);
 cv::Mat median(const cv::Mat& input, int kernelSize = 5, int numThreads = 0);
-cv::Mat bilateral(const cv::Mat& input, int d = 9, double sigmaColor = 75, double sigmaSpace = 75, int numThreads = 0);
+cv::Mat bilateral(const cv::Mat& input, int d = 9, double sigmaColor = 75, double sigmaSpace = 75, int numThreads = 0,
+                  Precision precision = Precision::DOUBLE);
+// Operação pontual por tabela (utils::make*Lut / composeLut): uma passada, qualquer número de canais
+cv::Mat applyLut(const cv::Mat& input, const utils::PointwiseLut& lut, int numThreads = 0);
+// Matriz de cor (utils::ColorMatrix); lut opcional aplicada na mesma passada (ex.: cinza + limiar)
+cv::Mat applyColorMatrix(const cv::Mat& input, const utils::ColorMatrix& matrix, const utils::PointwiseLut* lut = nullptr,
+                         int numThreads = 0, Precision precision = Precision::DOUBLE);
+
+// Saída como parâmetro: output é reaproveitado quando tamanho e tipo já batem (sem alocação no
+// laço de vídeo) e pode ser a própria entrada; filtros de vizinhança copiam a entrada nesse caso
+void grayscale(const cv::Mat& input, cv::Mat& output, int numThreads = 0, Precision precision = Precision::DOUBLE);
+void blur(const cv::Mat& input, cv::Mat& output, int kernelSize = 5, int numThreads = 0, Precision precision = Precision::DOUBLE);
+void boxBlur(const cv::Mat& input, cv::Mat& output, int kernelSize = 5, int numThreads = 0);
+void gaussianBlur(const cv::Mat& input, cv::Mat& output, int kernelSize = 5, int numThreads = 0, Precision precision = Precision::DOUBLE);
+void recursiveGaussianBlur(const cv::Mat& input, cv::Mat& output, double sigma, int numThreads = 0);
+void sobel(const cv::Mat& input, cv::Mat& output, int numThreads = 0, GradientNorm norm = GradientNorm::L2);
+void canny(const cv::Mat& input, cv::Mat& output, double threshold1 = 50, double threshold2 = 150, int numThreads = 0);
+void sharpen(const cv::Mat& input, cv::Mat& output, int numThreads = 0);
+void emboss(const cv::Mat& input, cv::Mat& output, int numThreads = 0);
+void negative(const cv::Mat& input, cv::Mat& output, int numThreads = 0);
+void sepia(const cv::Mat& input, cv::Mat& output, int numThreads = 0, Precision precision = Precision::DOUBLE);
+void threshold(const cv::Mat& input, cv::Mat& output, int thresholdValue = 128, int numThreads = 0);
+void median(const cv::Mat& input, cv::Mat& output, int kernelSize = 5, int numThreads = 0);
+void bilateral(const cv::Mat& input, cv::Mat& output, int d = 9, double sigmaColor = 75, double sigmaSpace = 75, int numThreads = 0,
+               Precision precision = Precision::DOUBLE);
+void applyLut(const cv::Mat& input, cv::Mat& output, const utils::PointwiseLut& lut, int numThreads = 0);
+void applyColorMatrix(const cv::Mat& input, cv::Mat& output, const utils::ColorMatrix& matrix, const utils::PointwiseLut* lut = nullptr,
+                      int numThreads = 0, Precision precision = Precision::DOUBLE);
+
+// Executa worker(inicio, fim) dividindo [0, rows) em até numThreads faixas de pelo menos grain
+// itens, no pool persistente (ThreadPool::global()); a thread que chama processa uma das faixas
+void runInThreads(int rows, int numThreads, const std::function<void(int,int)>& worker, int grain = 1);
+
+// Itens por faixa para que cada tarefa tenha ao menos kMinTaskBytes de dados: abaixo disso acordar
+// uma thread custa mais que o trabalho (uma miniatura 64x64 roda inteira na thread que chama)
+const size_t kMinTaskBytes = 16u << 10;
+int grainSize(size_t bytesPerItem);
 
 // Função para dividir trabalho entre threads
 void processRegion(const cv::Mat& input, cv::Mat& output, int startRow, int endRow,
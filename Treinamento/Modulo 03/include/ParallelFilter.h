@@ -2,26 +2,65 @@
 #define PARALLEL_FILTER_H
 
 #include <opencv2/opencv.hpp>
+#include <vector>
+#include "FilterUtils.h"
 
 namespace pavic {
 namespace parallel {
 
 // Filtros paralelos usando OpenMP (parallel for)
-cv::Mat grayscale(const cv::Mat& input);
-cv::Mat blur(const cv::Mat& input, int kernelSize = 5);
-cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize = 5);
-cv::Mat sobel(const cv::Mat& input);
+// precision: aritmética de convolução/cor/bilateral (DOUBLE = comportamento original)
+cv::Mat grayscale(const cv::Mat& input, Precision precision = Precision::DOUBLE);
+cv::Mat blur(const cv::Mat& input, int kernelSize = 5, Precision precision = Precision::DOUBLE);
+cv::Mat boxBlur(const cv::Mat& input, int kernelSize = 5);  // somas deslizantes, O(1) por pixel
+cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize = 5, Precision precision = Precision::DOUBLE);
+cv::Mat recursiveGaussianBlur(const cv::Mat& input, double sigma);  // IIR, O(1) por pixel em sigma
+cv::Mat sobel(const cv::Mat& input, GradientNorm norm = GradientNorm::L2);
 cv::Mat canny(const cv::Mat& input, double threshold1 = 50, double threshold2 = 150);
-cv::Mat sharpen(const cv::Mat& input);
+cv::Mat sharpen(const cv::Mat& input);  // kernels embutidos: inteiros, exatos em qualquer precisão
 cv::Mat emboss(const cv::Mat& input);
 cv::Mat negative(const cv::Mat& input);
-cv::Mat sepia(const cv::Mat& input);
+cv::Mat sepia(const cv::Mat& input, Precision precision = Precision::DOUBLE);
 cv::Mat threshold(const cv::Mat& input, int thresholdValue = 128);
 cv::Mat median(const cv::Mat& input, int kernelSize = 5);
-cv::Mat bilateral(const cv::Mat& input, int d = 9, double sigmaColor = 75, double sigmaSpace = 75);
+cv::Mat bilateral(const cv::Mat& input, int d = 9, double sigmaColor = 75, double sigmaSpace = 75,
+                  Precision precision = Precision::DOUBLE);
+// Operação pontual por tabela (utils::make*Lut / composeLut): uma passada, qualquer número de canais
+cv::Mat applyLut(const cv::Mat& input, const utils::PointwiseLut& lut);
+// Matriz de cor (utils::ColorMatrix); lut opcional aplicada na mesma passada (ex.: cinza + limiar)
+cv::Mat applyColorMatrix(const cv::Mat& input, const utils::ColorMatrix& matrix,
+                         const utils::PointwiseLut* lut = nullptr, Precision precision = Precision::DOUBLE);
+
+// Saída como parâmetro: output é reaproveitado quando tamanho e tipo já batem (sem alocação no
+// laço de vídeo) e pode ser a própria entrada; filtros de vizinhança copiam a entrada nesse caso
+void grayscale(const cv::Mat& input, cv::Mat& output, Precision precision = Precision::DOUBLE);
+void blur(const cv::Mat& input, cv::Mat& output, int kernelSize = 5, Precision precision = Precision::DOUBLE);
+void boxBlur(const cv::Mat& input, cv::Mat& output, int kernelSize = 5);
+void gaussianBlur(const cv::Mat& input, cv::Mat& output, int kernelSize = 5, Precision precision = Precision::DOUBLE);
+void recursiveGaussianBlur(const cv::Mat& input, cv::Mat& output, double sigma);
+void sobel(const cv::Mat& input, cv::Mat& output, GradientNorm norm = GradientNorm::L2);
+void canny(const cv::Mat& input, cv::Mat& output, double threshold1 = 50, double threshold2 = 150);
+void sharpen(const cv::Mat& input, cv::Mat& output);
+void emboss(const cv::Mat& input, cv::Mat& output);
+void negative(const cv::Mat& input, cv::Mat& output);
+void sepia(const cv::Mat& input, cv::Mat& output, Precision precision = Precision::DOUBLE);
+void threshold(const cv::Mat& input, cv::Mat& output, int thresholdValue = 128);
+void median(const cv::Mat& input, cv::Mat& output, int kernelSize = 5);
+void bilateral(const cv::Mat& input, cv::Mat& output, int d = 9, double sigmaColor = 75, double sigmaSpace = 75,
+               Precision precision = Precision::DOUBLE);
+void applyLut(const cv::Mat& input, cv::Mat& output, const utils::PointwiseLut& lut);
+void applyColorMatrix(const cv::Mat& input, cv::Mat& output, const utils::ColorMatrix& matrix,
+                      const utils::PointwiseLut* lut = nullptr, Precision precision = Precision::DOUBLE);
 
 // Função auxiliar para convolução paralela
-void applyConvolutionParallel(const cv::Mat& input, cv::Mat& output, const cv::Mat& kernel);
+void applyConvolutionParallel(const cv::Mat& input, cv::Mat& output, const cv::Mat& kernel,
+                              Precision precision = Precision::DOUBLE);
+// Convolução paralela com um kernel embutido (pesos constexpr, laços especializados)
+void applyBuiltinConvolutionParallel(const cv::Mat& input, cv::Mat& output, utils::BuiltinKernel kernel);
+// Convolução separável paralela (passe horizontal + passe vertical)
+void applySeparableConvolutionParallel(const cv::Mat& input, cv::Mat& output,
+                                       const std::vector<double>& kernelX, const std::vector<double>& kernelY,
+                                       Precision precision = Precision::DOUBLE);
 
 } // namespace parallel
 } // namespace pavic
@@ -0,0 +1,66 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+
+namespace pavic {
+
+struct ResultCacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;        // memória ocupada pelas imagens guardadas
+    size_t budgetBytes = 0;  // 0 = cache desligada
+};
+
+// Cache LRU de imagens resultantes, indexada por uma chave de 64 bits (hash do conteúdo da
+// entrada combinado com filtro, parâmetros e backend). As imagens são guardadas sem cópia:
+// quem recebe um resultado da cache não deve escrever nele.
+class ResultCache {
+public:
+    explicit ResultCache(size_t budgetBytes = 0);
+
+    // Orçamento de memória; ao reduzir, as entradas menos usadas saem até caber
+    void setBudget(size_t bytes);
+    size_t getBudget() const { return budget; }
+    bool isEnabled() const { return budget > 0; }
+
+    // Em caso de acerto devolve true e move a entrada para o topo da LRU
+    bool lookup(uint64_t key, cv::Mat& image);
+    // Imagens maiores que o orçamento inteiro não são guardadas
+    void insert(uint64_t key, const cv::Mat& image);
+    void clear();
+
+    ResultCacheStats getStats() const;
+
+    // Hash de 64 bits do conteúdo (linhas, colunas, tipo e pixels), lido em palavras de 8 bytes
+    // com quatro acumuladores independentes: custa uma fração de qualquer filtro sobre a imagem
+    static uint64_t hashImage(const cv::Mat& image);
+    static uint64_t combine(uint64_t seed, uint64_t value);
+
+private:
+    struct Entry {
+        uint64_t key;
+        cv::Mat image;
+        size_t bytes;
+    };
+
+    void evictUntil(size_t limit);
+
+    std::list<Entry> entries;  // frente = usada mais recentemente
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+    size_t budget;
+    size_t bytes = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+};
+
+} // namespace pavic
+
+#endif // RESULT_CACHE_H
@@ -0,0 +1,60 @@
+#ifndef SIMD_FILTER_H
+#define SIMD_FILTER_H
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include "FilterUtils.h"
+
+namespace pavic {
+namespace simd {
+
+// Conjunto de instruções em uso ("AVX2", "SSE4.1" ou "Scalar"): o do build, se a CPU o suporta.
+// Sem ele os filtros abaixo recaem no backend multithread.
+std::string getInstructionSet();
+bool isSIMDAvailable();
+
+// Filtros vetorizados (SSE4.1/AVX2) sobre linhas de bytes.
+// numThreads = 1 executa só SIMD; 0 usa todas as threads de hardware (SIMD + threads).
+cv::Mat grayscale(const cv::Mat& input, int numThreads = 1);
+cv::Mat blur(const cv::Mat& input, int kernelSize = 5, int numThreads = 1);
+cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize = 5, int numThreads = 1);
+cv::Mat sobel(const cv::Mat& input, int numThreads = 1, GradientNorm norm = GradientNorm::L2);
+cv::Mat canny(const cv::Mat& input, double threshold1 = 50, double threshold2 = 150, int numThreads = 1);
+cv::Mat sharpen(const cv::Mat& input, int numThreads = 1);
+cv::Mat emboss(const cv::Mat& input, int numThreads = 1);
+cv::Mat negative(const cv::Mat& input, int numThreads = 1);
+cv::Mat sepia(const cv::Mat& input, int numThreads = 1);
+cv::Mat threshold(const cv::Mat& input, int thresholdValue = 128, int numThreads = 1);
+cv::Mat median(const cv::Mat& input, int kernelSize = 5, int numThreads = 1);
+cv::Mat bilateral(const cv::Mat& input, int d = 9, double sigmaColor = 75, double sigmaSpace = 75, int numThreads = 1);
+// Operação pontual por tabela (utils::make*Lut / composeLut); AVX2 consulta 8 bytes por gather
+cv::Mat applyLut(const cv::Mat& input, const utils::PointwiseLut& lut, int numThreads = 1);
+// Matriz de cor (utils::ColorMatrix) em Q14 com LUT opcional na mesma passada
+cv::Mat applyColorMatrix(const cv::Mat& input, const utils::ColorMatrix& matrix,
+                         const utils::PointwiseLut* lut = nullptr, int numThreads = 1);
+
+// Saída como parâmetro: output é reaproveitado quando tamanho e tipo já batem (sem alocação no
+// laço de vídeo) e pode ser a própria entrada; filtros de vizinhança copiam a entrada nesse caso
+void grayscale(const cv::Mat& input, cv::Mat& output, int numThreads = 1);
+void blur(const cv::Mat& input, cv::Mat& output, int kernelSize = 5, int numThreads = 1);
+void gaussianBlur(const cv::Mat& input, cv::Mat& output, int kernelSize = 5, int numThreads = 1);
+void sobel(const cv::Mat& input, cv::Mat& output, int numThreads = 1, GradientNorm norm = GradientNorm::L2);
+void canny(const cv::Mat& input, cv::Mat& output, double threshold1 = 50, double threshold2 = 150, int numThreads = 1);
+void sharpen(const cv::Mat& input, cv::Mat& output, int numThreads = 1);
+void emboss(const cv::Mat& input, cv::Mat& output, int numThreads = 1);
+void negative(const cv::Mat& input, cv::Mat& output, int numThreads = 1);
+void sepia(const cv::Mat& input, cv::Mat& output, int numThreads = 1);
+void threshold(const cv::Mat& input, cv::Mat& output, int thresholdValue = 128, int numThreads = 1);
+void median(const cv::Mat& input, cv::Mat& output, int kernelSize = 5, int numThreads = 1);
+void bilateral(const cv::Mat& input, cv::Mat& output, int d = 9, double sigmaColor = 75, double sigmaSpace = 75, int numThreads = 1);
+void applyLut(const cv::Mat& input, cv::Mat& output, const utils::PointwiseLut& lut, int numThreads = 1);
+void applyColorMatrix(const cv::Mat& input, cv::Mat& output, const utils::ColorMatrix& matrix,
+                      const utils::PointwiseLut* lut = nullptr, int numThreads = 1);
+
+// SAD entre a e b na região com psadbw (16/32 bytes por instrução); para ao passar de limit
+uint64_t sumAbsDiff(const cv::Mat& a, const cv::Mat& b, const cv::Rect& region, uint64_t limit = UINT64_MAX);
+
+} // namespace simd
+} // namespace pavic
+
+#endif // SIMD_FILTER_H
@@ -0,0 +1,69 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+// Núcleos com intrínsecos do backend SIMD, sobre linhas de bytes.
+//
+// Só SimdKernels.cpp é compilado com -mavx2/-msse4.1 (/arch:AVX2): ele e este cabeçalho não
+// incluem OpenCV nem a biblioteca padrão do C++, para que nenhuma função inline ou template dessas
+// bibliotecas seja gerada com instruções que a CPU talvez não tenha (o linker poderia escolher essa
+// cópia para o programa inteiro). O build define PAVIC_SIMD_AVX2 ou PAVIC_SIMD_SSE41 conforme as
+// flags desse arquivo; SimdFilter.cpp confere a CPU em tempo de execução antes de chamar qualquer núcleo.
+//
+// Cada núcleo de linha processa a parte vetorizável e devolve onde parou (em bytes, ou em pixels
+// quando indicado); quem chama completa a sobra em escalar.
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace pavic {
+namespace simd {
+namespace kernels {
+
+// Tap de convolução / bilateral: linha da janela, deslocamento em bytes nessa linha e peso
+struct Tap {
+    int row;
+    int offset;
+    float weight;
+};
+
+enum class Norm { L2, L1, FAST };
+
+// Matriz de cor Q14 sobre BGR intercalado, 16 pixels por iteração; pesos em int16 (|coeficiente| < 2).
+// Com threshold em [0, 254] a saída é (v > threshold ? 255 : 0); senão, com lut, lut[v]. Devolve pixels.
+int colorMatrixRow(const uint8_t* src, uint8_t* dst, int cols, const int (*weights)[3], int outChannels,
+                   int shift, const uint8_t* lut, int threshold);
+
+// Soma dos taps (rows[tap.row] + tap.offset + j) * peso, arredondada e saturada em 8 bits
+int convolveRow(const uint8_t* const* rows, const Tap* taps, int tapCount, uint8_t* dst, int rowLen);
+
+// Convolução separável: passe horizontal (src já com k/2 pixels de borda de cada lado) para float
+// e passe vertical sobre k linhas float, arredondado e saturado em 8 bits
+int separableRowH(const uint8_t* src, float* dst, int rowLen, const float* weights, int k, int cn);
+int separableRowV(const float* const* rows, uint8_t* dst, int rowLen, const float* weights, int k);
+
+// Sobel 3x3 a partir de três linhas com 1 pixel de borda; magnitude truncada na norma pedida. Devolve pixels.
+int sobelRow(const uint8_t* p0, const uint8_t* p1, const uint8_t* p2, uint8_t* dst, int cols, Norm norm);
+// Mesmo Sobel, com gx, gy e a magnitude L2 truncada por pixel (para o gradiente compactado do Canny)
+int cannyGradientRow(const uint8_t* p0, const uint8_t* p1, const uint8_t* p2, int cols,
+                     int* gx, int* gy, int* magnitude);
+
+int addSaturateRow(uint8_t* row, int len, int value);
+int invertRow(const uint8_t* src, uint8_t* dst, int len);
+int thresholdRow(const uint8_t* src, uint8_t* dst, int len, int threshold);   // threshold em [0, 254]
+#if defined(PAVIC_SIMD_AVX2)
+// LUT por vpgatherdd sobre a tabela copiada em int32
+int lutRow(const uint8_t* src, uint8_t* dst, int len, const int* table);
+#endif
+
+// Bilateral por canal: peso espacial no tap, peso de cor em colorLut[|centro - vizinho|]
+int bilateralRow(const uint8_t* const* rows, const uint8_t* center, const Tap* taps, int tapCount,
+                 const float* colorLut, uint8_t* dst, int rowLen);
+
+// SAD da linha inteira com psadbw
+uint64_t sumAbsDiffRow(const uint8_t* a, const uint8_t* b, size_t len);
+
+} // namespace kernels
+} // namespace simd
+} // namespace pavic
+
+#endif // SIMD_KERNELS_H
@@ -0,0 +1,53 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pavic {
+
+// Pool de threads persistente para o backend multithread: os workers são criados uma vez e
+// dormem numa variável de condição entre as chamadas. Cada parallelFor publica um job na fila; os
+// pedaços do job são disputados com um contador atômico (a trava só protege publicar/retirar o
+// job) e a thread que chamou também processa pedaços, então chamadas aninhadas ou simultâneas
+// nunca ficam esperando por um worker livre.
+class ThreadPool {
+public:
+    // workerCount: threads além da que chama (0 = hardware_concurrency() - 1)
+    explicit ThreadPool(int workerCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Instância do processo, criada no primeiro uso
+    static ThreadPool& global();
+
+    // Executa body(inicio, fim) sobre [0, count) em até maxThreads pedaços contíguos de pelo menos
+    // grain itens (maxThreads <= 0: workers + 1). Com um pedaço só roda direto na thread que chama.
+    // Retorna quando todos os pedaços terminaram; uma exceção de body é relançada aqui.
+    void parallelFor(int count, int maxThreads, int grain, const std::function<void(int, int)>& body);
+
+    int getWorkerCount() const { return static_cast<int>(workers.size()); }
+
+private:
+    struct Job;
+
+    void workerLoop();
+    static bool runChunk(Job& job);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::shared_ptr<Job>> queue;
+    bool stopping = false;
+};
+
+} // namespace pavic
+
+#endif // THREAD_POOL_H
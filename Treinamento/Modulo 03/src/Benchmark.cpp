@@ -4,7 +4,12 @@
  */
 
 #include "ImageProcessor.h"
+#include "IncrementalProcessor.h"
+#include "BufferPool.h"
 #include "PerformanceMetrics.h"
+#include "SequentialFilter.h"
+#include "ParallelFilter.h"
+#include "MultithreadFilter.h"
 
 #include <opencv2/opencv.hpp>
 #include <iostream>
@@ -12,17 +17,22 @@
 #include <iomanip>
 #include <vector>
 #include <string>
+#include <cstdio>
+#include <chrono>
+#include <cmath>
 #include <direct.h>  // Para _mkdir no Windows
 
 using namespace pavic;
 
-void runBenchmark(const cv::Mat& image, PerformanceMetrics& metrics, int iterations = 5) {
+void runBenchmark(const cv::Mat& image, PerformanceMetrics& metrics, int iterations = 5,
+                  Precision precision = Precision::DOUBLE) {
     if (image.empty()) {
         std::cerr << "Imagem vazia para benchmark!\n";
         return;
     }
 
     ImageProcessor processor;
+    processor.setPrecision(precision);
     
     std::vector<FilterType> filters = {
         FilterType::GRAYSCALE,
@@ -42,7 +52,9 @@ void runBenchmark(const cv::Mat& image, PerformanceMetrics& metrics, int iterati
     std::vector<ProcessingType> procs = {
         ProcessingType::SEQUENTIAL,
         ProcessingType::PARALLEL,
-        ProcessingType::MULTITHREAD
+        ProcessingType::MULTITHREAD,
+        ProcessingType::SIMD,
+        ProcessingType::SIMD_MULTITHREAD
     };
 
 #if PAVIC_HAVE_CUDA
@@ -53,6 +65,7 @@ void runBenchmark(const cv::Mat& image, PerformanceMetrics& metrics, int iterati
     std::cout << "   PAVIC LAB 2025 - BENCHMARK\n";
     std::cout << "   Imagem: " << image.cols << "x" << image.rows << "\n";
     std::cout << "   Iteracoes: " << iterations << "\n";
+    std::cout << "   Precisao: " << utils::getPrecisionName(precision) << "\n";
     std::cout << "========================================\n\n" << std::flush;
 
     for (const auto& filter : filters) {
@@ -92,6 +105,357 @@ void runBenchmark(const cv::Mat& image, PerformanceMetrics& metrics, int iterati
     }
 }
 
+// Gaussiana recursiva (IIR) x kernel denso separável, sequencial, mesmo sigma
+void compareRecursiveGaussian(const cv::Mat& image) {
+    std::cout << "\n========================================\n";
+    std::cout << "   GAUSSIANA RECURSIVA x KERNEL DENSO\n";
+    std::cout << "========================================\n\n";
+    std::cout << std::setw(8) << std::left << "Kernel" << std::setw(8) << "Sigma"
+              << std::setw(12) << "Denso ms" << std::setw(12) << "IIR ms"
+              << std::setw(12) << "Erro max" << std::setw(12) << "Erro medio" << "PSNR dB\n";
+    std::cout << std::string(72, '-') << "\n";
+
+    for (int size : {5, 9, 15, 25, 41, 61}) {
+        double sigma = utils::getGaussianSigma(size);
+        std::vector<double> kernel = utils::getGaussianKernel1D(size);
+
+        auto t0 = std::chrono::high_resolution_clock::now();
+        cv::Mat dense;
+        sequential::applySeparableConvolution(image, dense, kernel, kernel);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        cv::Mat recursive = sequential::recursiveGaussianBlur(image, sigma);
+        auto t2 = std::chrono::high_resolution_clock::now();
+
+        int maxErr = 0;
+        double sumErr = 0, sumSq = 0;
+        int rowLen = image.cols * image.channels();
+        for (int i = 0; i < image.rows; ++i) {
+            const uchar* a = dense.ptr<uchar>(i);
+            const uchar* r = recursive.ptr<uchar>(i);
+            for (int j = 0; j < rowLen; ++j) {
+                int e = std::abs(a[j] - r[j]);
+                maxErr = std::max(maxErr, e);
+                sumErr += e;
+                sumSq += e * e;
+            }
+        }
+        double count = static_cast<double>(image.rows) * rowLen;
+        double mse = sumSq / count;
+
+        std::cout << std::setw(8) << std::left << size
+                  << std::setw(8) << std::fixed << std::setprecision(2) << sigma
+                  << std::setw(12) << std::chrono::duration<double, std::milli>(t1 - t0).count()
+                  << std::setw(12) << std::chrono::duration<double, std::milli>(t2 - t1).count()
+                  << std::setw(12) << maxErr
+                  << std::setw(12) << std::setprecision(3) << sumErr / count;
+        if (mse > 0) std::cout << std::setprecision(1) << 10.0 * std::log10(255.0 * 255.0 / mse) << "\n";
+        else std::cout << "inf\n";
+    }
+    std::cout << "\ngaussianBlur usa a versao recursiva para kernels > "
+              << utils::getRecursiveGaussianThreshold() << "\n";
+}
+
+// Blur por somas deslizantes x blur separável (double), k ímpar e par: tempo e maior diferença.
+// A única diferença esperada é o desempate do arredondamento (x.5 sobe na soma inteira)
+void compareBoxBlur(const cv::Mat& image) {
+    std::cout << "\n========================================\n";
+    std::cout << "   BOX BLUR (SOMAS) x BLUR SEPARAVEL\n";
+    std::cout << "========================================\n\n";
+    std::cout << std::setw(8) << std::left << "Kernel" << std::setw(18) << "Backend"
+              << std::setw(12) << "Blur ms" << std::setw(12) << "Box ms"
+              << std::setw(12) << "Erro max" << "Bytes diferentes\n";
+    std::cout << std::string(78, '-') << "\n";
+
+    for (int size : {5, 4, 15, 16}) {
+        auto t0 = std::chrono::high_resolution_clock::now();
+        cv::Mat reference;
+        sequential::blur(image, reference, size, Precision::DOUBLE);
+        double blurMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+
+        for (auto proc : {ProcessingType::SEQUENTIAL, ProcessingType::PARALLEL, ProcessingType::MULTITHREAD}) {
+            cv::Mat box;
+            auto t1 = std::chrono::high_resolution_clock::now();
+            if (proc == ProcessingType::SEQUENTIAL) sequential::boxBlur(image, box, size);
+            else if (proc == ProcessingType::PARALLEL) parallel::boxBlur(image, box, size);
+            else multithread::boxBlur(image, box, size);
+            auto t2 = std::chrono::high_resolution_clock::now();
+
+            int maxErr = 0;
+            long long diffCount = 0;
+            int rowLen = image.cols * image.channels();
+            for (int i = 0; i < image.rows; ++i) {
+                const uchar* a = reference.ptr<uchar>(i);
+                const uchar* r = box.ptr<uchar>(i);
+                for (int j = 0; j < rowLen; ++j) {
+                    int e = std::abs(a[j] - r[j]);
+                    maxErr = std::max(maxErr, e);
+                    diffCount += e != 0;
+                }
+            }
+            std::cout << std::setw(8) << std::left << size
+                      << std::setw(18) << ImageProcessor::getProcessingName(proc)
+                      << std::setw(12) << std::fixed << std::setprecision(3) << blurMs
+                      << std::setw(12) << std::chrono::duration<double, std::milli>(t2 - t1).count()
+                      << std::setw(12) << maxErr << diffCount
+                      << (maxErr > 1 ? "  | DIVERGE do blur" : "") << "\n";
+        }
+    }
+}
+
+// Imagem integral: windowSum (32 e 64 bits, soma dos quadrados), variableBoxBlur e
+// localMeanVariance contra somas de janela por força bruta, em 1 e 3 canais; variableBoxBlur de
+// raio fixo contra boxBlur no interior (nas bordas um recorta a janela, o outro replica)
+void compareIntegral(const cv::Mat& image) {
+    std::cout << "\n========================================\n";
+    std::cout << "   IMAGEM INTEGRAL x FORCA BRUTA\n";
+    std::cout << "========================================\n\n";
+    std::cout << std::setw(8) << std::left << "Canais" << std::setw(28) << "Consulta"
+              << std::setw(12) << "Tempo ms" << "Erro max\n";
+    std::cout << std::string(60, '-') << "\n";
+
+    uint32_t seed = 12345;
+    auto next = [&seed](int n) {
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<int>((seed >> 8) % static_cast<uint32_t>(n));
+    };
+    auto report = [](int cn, const char* name, double ms, double err) {
+        std::cout << std::setw(8) << std::left << cn << std::setw(28) << name << std::setw(12)
+                  << std::fixed << std::setprecision(3) << ms << std::setprecision(6) << err
+                  << (err > 1e-3 ? "  | DIVERGE" : "") << "\n";
+    };
+
+    for (const cv::Mat& input : {sequential::grayscale(image), image}) {
+        const int cn = input.channels();
+
+        // windowSum em janelas aleatórias (e a imagem inteira) sobre as três tabelas
+        auto t0 = std::chrono::high_resolution_clock::now();
+        cv::Mat sum32, sum64, sqsum;
+        utils::integral(input, sum32, CV_32S);
+        utils::integral(input, sum64, sqsum, CV_64F);
+        double buildMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+        double err32 = 0, err64 = 0, errSq = 0;
+        for (int w = 0; w <= 500; ++w) {
+            int y0 = 0, x0 = 0, y1 = input.rows, x1 = input.cols;
+            if (w > 0) {
+                y0 = next(input.rows);
+                x0 = next(input.cols);
+                y1 = std::min(input.rows, y0 + 1 + next(200));
+                x1 = std::min(input.cols, x0 + 1 + next(200));
+            }
+            for (int c = 0; c < cn; ++c) {
+                double s = 0, sq = 0;
+                for (int i = y0; i < y1; ++i) {
+                    const uchar* p = input.ptr<uchar>(i);
+                    for (int j = x0; j < x1; ++j) {
+                        s += p[j * cn + c];
+                        sq += p[j * cn + c] * p[j * cn + c];
+                    }
+                }
+                err32 = std::max(err32, std::abs(utils::windowSum<int>(sum32, y0, x0, y1, x1, c) - s));
+                err64 = std::max(err64, std::abs(utils::windowSum<double>(sum64, y0, x0, y1, x1, c) - s));
+                errSq = std::max(errSq, std::abs(utils::windowSum<double>(sqsum, y0, x0, y1, x1, c) - sq));
+            }
+        }
+        report(cn, "windowSum 32 bits", buildMs, err32);
+        report(cn, "windowSum 64 bits", buildMs, err64);
+        report(cn, "windowSum quadrados", buildMs, errSq);
+
+        // Consultas por pixel num recorte 256x256 (a força bruta custa a área da janela por pixel)
+        cv::Mat crop = input(cv::Rect(0, 0, std::min(256, input.cols), std::min(256, input.rows)));
+        cv::Mat radius(crop.size(), CV_8UC1);
+        for (int i = 0; i < radius.rows; ++i) {
+            for (int j = 0; j < radius.cols; ++j) radius.at<uchar>(i, j) = static_cast<uchar>(next(21));
+        }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        cv::Mat blurred = utils::variableBoxBlur(crop, radius);
+        auto t2 = std::chrono::high_resolution_clock::now();
+        const int k = 7;
+        cv::Mat mean, variance;
+        utils::localMeanVariance(crop, k, mean, variance);
+        auto t3 = std::chrono::high_resolution_clock::now();
+
+        double errBlur = 0, errMean = 0, errVar = 0;
+        for (int i = 0; i < crop.rows; ++i) {
+            for (int j = 0; j < crop.cols; ++j) {
+                for (int pass = 0; pass < 2; ++pass) {
+                    int r = pass == 0 ? radius.at<uchar>(i, j) : k / 2;
+                    int y0 = std::max(0, i - r), y1 = std::min(crop.rows, i + r + 1);
+                    int x0 = std::max(0, j - r), x1 = std::min(crop.cols, j + r + 1);
+                    double area = static_cast<double>(y1 - y0) * (x1 - x0);
+                    for (int c = 0; c < cn; ++c) {
+                        double s = 0, sq = 0;
+                        for (int y = y0; y < y1; ++y) {
+                            const uchar* p = crop.ptr<uchar>(y);
+                            for (int x = x0; x < x1; ++x) {
+                                s += p[x * cn + c];
+                                sq += p[x * cn + c] * p[x * cn + c];
+                            }
+                        }
+                        int idx = j * cn + c;
+                        if (pass == 0) {
+                            errBlur = std::max(errBlur, std::abs(blurred.ptr<uchar>(i)[idx] -
+                                                                 static_cast<double>(cv::saturate_cast<uchar>(s / area))));
+                        } else {
+                            double mu = s / area;
+                            errMean = std::max(errMean, std::abs(mean.ptr<float>(i)[idx] - mu));
+                            errVar = std::max(errVar, std::abs(variance.ptr<float>(i)[idx] - std::max(0.0, sq / area - mu * mu)) /
+                                                      std::max(1.0, sq / area - mu * mu));
+                        }
+                    }
+                }
+            }
+        }
+        report(cn, "variableBoxBlur 256x256", std::chrono::duration<double, std::milli>(t2 - t1).count(), errBlur);
+        report(cn, "media local 7x7", std::chrono::duration<double, std::milli>(t3 - t2).count(), errMean);
+        report(cn, "variancia local 7x7 (rel.)", std::chrono::duration<double, std::milli>(t3 - t2).count(), errVar);
+
+        cv::Mat fixedBlur = utils::variableBoxBlur(crop, cv::Mat(crop.size(), CV_8UC1, cv::Scalar(k / 2)));
+        cv::Mat box;
+        sequential::boxBlur(crop, box, k);
+        double errBox = 0;
+        for (int i = k / 2; i < crop.rows - k / 2; ++i) {
+            for (int j = (k / 2) * cn; j < (crop.cols - k / 2) * cn; ++j) {
+                errBox = std::max(errBox, std::abs(static_cast<double>(fixedBlur.ptr<uchar>(i)[j]) - box.ptr<uchar>(i)[j]));
+            }
+        }
+        report(cn, "raio fixo x boxBlur 7x7", 0.0, errBox);
+    }
+}
+
+// Mesma imagem byte a byte: tamanho, tipo e conteúdo
+static bool sameImage(const cv::Mat& a, const cv::Mat& b) {
+    return a.size() == b.size() && a.type() == b.type() && cv::countNonZero(a.reshape(1) != b.reshape(1)) == 0;
+}
+
+// Cadeia de produção Blur -> Sharpen -> Threshold: passo a passo x fundida (intercalada e planar),
+// tempo por estágio; as fundidas são conferidas contra o passo a passo
+void comparePipeline(const cv::Mat& image, int iterations, Precision precision) {
+    std::cout << "\n========================================\n";
+    std::cout << "   CADEIA BLUR -> SHARPEN -> THRESHOLD\n";
+    std::cout << "========================================\n\n";
+
+    ImageProcessor processor;
+    processor.setPrecision(precision);
+    std::vector<FilterStep> steps = {
+        FilterStep{FilterType::BLUR},
+        FilterStep{FilterType::SHARPEN},
+        FilterStep{FilterType::THRESHOLD}
+    };
+
+    for (auto proc : {ProcessingType::SEQUENTIAL, ProcessingType::PARALLEL, ProcessingType::MULTITHREAD,
+                      ProcessingType::SIMD, ProcessingType::SIMD_MULTITHREAD}) {
+        cv::Mat reference;
+        for (int mode = 0; mode < 3; ++mode) {
+            bool fuse = mode > 0, planar = mode == 2;
+            PipelineResult last;
+            double totalTime = 0.0;
+            for (int i = 0; i < iterations; ++i) {
+                last = processor.processFramePipeline(image, steps, proc, fuse, planar);
+                if (!last.success) break;
+                totalTime += last.executionTimeMs;
+            }
+            std::cout << "  " << std::setw(15) << std::left << ImageProcessor::getProcessingName(proc)
+                      << std::setw(16) << (planar ? "fundida planar" : fuse ? "fundida" : "passo a passo");
+            if (!last.success) {
+                std::cout << "FALHOU - " << last.errorMessage << "\n";
+                continue;
+            }
+            std::cout << std::fixed << std::setprecision(3) << totalTime / iterations << " ms (media)";
+            for (const auto& stage : last.stages) {
+                std::cout << " | " << stage.name << " " << std::setprecision(2) << stage.executionTimeMs;
+            }
+            // A imagem devolvida pode estar num buffer interno da cadeia
+            if (!fuse) reference = last.image.clone();
+            else if (!sameImage(reference, last.image)) std::cout << " | DIVERGE do passo a passo";
+            std::cout << "\n";
+        }
+    }
+}
+
+// Região 640x480 no centro da imagem: imagem inteira x só a ROI (ROI + halo lidos); o resultado
+// da ROI é conferido contra o recorte da imagem inteira
+void compareROI(const cv::Mat& image, int iterations, Precision precision) {
+    std::cout << "\n========================================\n";
+    std::cout << "   IMAGEM INTEIRA x ROI 640x480\n";
+    std::cout << "========================================\n\n";
+
+    ImageProcessor processor;
+    processor.setPrecision(precision);
+    cv::Rect roi((image.cols - 640) / 2, (image.rows - 480) / 2, 640, 480);
+    roi &= cv::Rect(0, 0, image.cols, image.rows);
+
+    for (auto filter : {FilterType::BLUR, FilterType::GAUSSIAN_BLUR, FilterType::SOBEL,
+                        FilterType::SHARPEN, FilterType::MEDIAN, FilterType::BILATERAL}) {
+        for (auto proc : {ProcessingType::SEQUENTIAL, ProcessingType::SIMD_MULTITHREAD}) {
+            double fullTime = 0.0, roiTime = 0.0;
+            ProcessingResult full{}, region{};
+            for (int i = 0; i < iterations; ++i) {
+                full = processor.processFrame(image, filter, proc, false);
+                region = processor.processFrameROI(image, roi, filter, proc);
+                fullTime += full.executionTimeMs;
+                roiTime += region.executionTimeMs;
+            }
+            std::cout << "  " << std::setw(15) << std::left << ImageProcessor::getFilterName(filter)
+                      << std::setw(15) << ImageProcessor::getProcessingName(proc)
+                      << std::fixed << std::setprecision(3) << fullTime / iterations << " ms -> "
+                      << roiTime / iterations << " ms (ROI)";
+            if (!full.success || !region.success || !sameImage(full.image(roi), region.image)) {
+                std::cout << " | DIVERGE da imagem inteira";
+            }
+            std::cout << "\n";
+        }
+    }
+}
+
+// Câmera fixa simulada: cena estática com um quadrado 64x64 em movimento, quadro inteiro x incremental.
+// Um segundo processador com limiar 0 confere cada quadro contra o quadro inteiro
+void compareIncremental(const cv::Mat& image, int iterations, Precision precision) {
+    std::cout << "\n========================================\n";
+    std::cout << "   QUADRO INTEIRO x INCREMENTAL (tiles)\n";
+    std::cout << "========================================\n\n";
+
+    const int frames = std::max(iterations, 2) * 4;
+    std::vector<cv::Mat> sequence;
+    for (int f = 0; f < frames; ++f) {
+        cv::Mat frame = image.clone();
+        cv::Rect box((f * 37) % std::max(1, image.cols - 64), (f * 23) % std::max(1, image.rows - 64), 64, 64);
+        frame(box & cv::Rect(0, 0, image.cols, image.rows)).setTo(cv::Scalar(0, 255, 255));
+        sequence.push_back(frame);
+    }
+
+    ImageProcessor processor;
+    processor.setPrecision(precision);
+    for (auto filter : {FilterType::BLUR, FilterType::SOBEL, FilterType::MEDIAN, FilterType::BILATERAL}) {
+        for (auto proc : {ProcessingType::SEQUENTIAL, ProcessingType::SIMD_MULTITHREAD}) {
+            IncrementalProcessor incremental;
+            incremental.setPrecision(precision);
+            IncrementalProcessor exact(incremental.getTileSize(), 0.0);
+            exact.setPrecision(precision);
+            double fullTime = 0.0, incTime = 0.0, ratio = 0.0;
+            bool identical = true;
+            for (int f = 0; f < frames; ++f) {
+                ProcessingResult full = processor.processFrame(sequence[f], filter, proc, false);
+                fullTime += full.executionTimeMs;
+                double t = incremental.processFrame(sequence[f], filter, proc).executionTimeMs;
+                ProcessingResult check = exact.processFrame(sequence[f], filter, proc);
+                identical = identical && full.success && check.success && sameImage(full.image, check.image);
+                // O primeiro quadro é sempre inteiro
+                if (f > 0) {
+                    incTime += t;
+                    ratio += incremental.getStats().recomputeRatio;
+                }
+            }
+            std::cout << "  " << std::setw(15) << std::left << ImageProcessor::getFilterName(filter)
+                      << std::setw(15) << ImageProcessor::getProcessingName(proc)
+                      << std::fixed << std::setprecision(3) << fullTime / frames << " ms -> "
+                      << incTime / (frames - 1) << " ms (recalculo "
+                      << std::setprecision(1) << 100.0 * ratio / (frames - 1) << "%)";
+            if (!identical) std::cout << " | DIVERGE do quadro inteiro (limiar 0)";
+            std::cout << "\n";
+        }
+    }
+}
+
 void printComparisonTable(const PerformanceMetrics& metrics) {
     std::cout << "\n========================================\n";
     std::cout << "   COMPARACAO DE DESEMPENHO\n";
@@ -103,22 +467,26 @@ void printComparisonTable(const PerformanceMetrics& metrics) {
               << std::setw(12) << "Sequential"
               << std::setw(12) << "Parallel"
               << std::setw(12) << "Multithread"
+              << std::setw(12) << "SIMD"
+              << std::setw(14) << "SIMD+Threads"
 #if PAVIC_HAVE_CUDA
               << std::setw(12) << "CUDA"
 #endif
               << std::setw(10) << "Speedup"
               << "\n";
-    std::cout << std::string(70, '-') << "\n";
+    std::cout << std::string(96, '-') << "\n";
 
     for (const auto& cmp : comparisons) {
         std::cout << std::setw(15) << std::left << ImageProcessor::getFilterName(cmp.filter);
 
-        for (auto pt : {ProcessingType::SEQUENTIAL, ProcessingType::PARALLEL, ProcessingType::MULTITHREAD}) {
+        for (auto pt : {ProcessingType::SEQUENTIAL, ProcessingType::PARALLEL, ProcessingType::MULTITHREAD,
+                        ProcessingType::SIMD, ProcessingType::SIMD_MULTITHREAD}) {
+            int width = pt == ProcessingType::SIMD_MULTITHREAD ? 14 : 12;
             auto it = cmp.times.find(pt);
             if (it != cmp.times.end()) {
-                std::cout << std::setw(12) << std::fixed << std::setprecision(2) << it->second;
+                std::cout << std::setw(width) << std::fixed << std::setprecision(2) << it->second;
             } else {
-                std::cout << std::setw(12) << "N/A";
+                std::cout << std::setw(width) << "N/A";
             }
         }
 
@@ -142,6 +510,14 @@ int main(int argc, char** argv) {
         std::string imgPath;
         std::string outputCSV = "results/benchmark_results.csv";
         int iterations = 5;
+        Precision precision = Precision::DOUBLE;
+        bool gaussianAccuracy = false;
+        bool boxAccuracy = false;
+        bool integralAccuracy = false;
+        bool pipeline = false;
+        bool roi = false;
+        bool incremental = false;
+        bool bufferPool = false;
 
         for (int i = 1; i < argc; ++i) {
             std::string arg = argv[i];
@@ -151,11 +527,46 @@ int main(int argc, char** argv) {
                 outputCSV = argv[++i];
             } else if ((arg == "--iterations" || arg == "-n") && i + 1 < argc) {
                 iterations = std::stoi(argv[++i]);
+            } else if ((arg == "--precision" || arg == "-p") && i + 1 < argc) {
+                std::string p = argv[++i];
+                if (p == "float") precision = Precision::FLOAT32;
+                else if (p == "fixed") precision = Precision::FIXED_POINT;
+                else precision = Precision::DOUBLE;
+            } else if ((arg == "--tile" || arg == "-t") && i + 1 < argc) {
+                // <linhas>x<colunas>; 0 = automático pela cache L2
+                utils::TileSize tile;
+                if (std::sscanf(argv[++i], "%dx%d", &tile.rows, &tile.cols) == 2) utils::setTileSize(tile);
+            } else if ((arg == "--iir-threshold" || arg == "-g") && i + 1 < argc) {
+                utils::setRecursiveGaussianThreshold(std::stoi(argv[++i]));
+            } else if (arg == "--iir-accuracy") {
+                gaussianAccuracy = true;
+            } else if (arg == "--box-accuracy") {
+                boxAccuracy = true;
+            } else if (arg == "--integral-accuracy") {
+                integralAccuracy = true;
+            } else if (arg == "--pipeline") {
+                pipeline = true;
+            } else if (arg == "--roi") {
+                roi = true;
+            } else if (arg == "--incremental") {
+                incremental = true;
+            } else if (arg == "--buffer-pool") {
+                bufferPool = true;
             } else if (arg == "--help" || arg == "-h") {
                 std::cout << "Uso: Benchmark [opcoes]\n"
                           << "  -i, --image <path>       Caminho da imagem\n"
                           << "  -o, --output <path>      Arquivo CSV de saida\n"
                           << "  -n, --iterations <num>   Numero de iteracoes\n"
+                          << "  -p, --precision <modo>   double (padrao), float ou fixed\n"
+                          << "  -t, --tile <RxC>         Tamanho do tile (ex. 128x256; 0x0 = automatico)\n"
+                          << "  -g, --iir-threshold <k>  Gaussiana recursiva para kernels > k (padrao 15)\n"
+                          << "      --iir-accuracy       Comparar Gaussiana recursiva x kernel denso\n"
+                          << "      --box-accuracy       Comparar blur por somas deslizantes x blur separavel\n"
+                          << "      --integral-accuracy  Imagem integral x somas de janela por forca bruta\n"
+                          << "      --pipeline           Cadeia Blur->Sharpen->Threshold: passo a passo x fundida\n"
+                          << "      --roi                Imagem inteira x ROI 640x480 central\n"
+                          << "      --incremental        Quadro inteiro x tiles mudados (cena fixa simulada)\n"
+                          << "      --buffer-pool        Alocar cv::Mat pelo BufferPool (reciclagem entre iteracoes)\n"
                           << "  -h, --help               Mostrar ajuda\n";
                 return 0;
             }
@@ -178,9 +589,22 @@ int main(int argc, char** argv) {
         std::cerr << "Imagem pronta: " << image.cols << "x" << image.rows << "\n" << std::flush;
 
         PerformanceMetrics metrics;
+        if (bufferPool) BufferPool::global().install();
 
-        runBenchmark(image, metrics, iterations);
+        runBenchmark(image, metrics, iterations, precision);
         printComparisonTable(metrics);
+        if (gaussianAccuracy) compareRecursiveGaussian(image);
+        if (boxAccuracy) compareBoxBlur(image);
+        if (integralAccuracy) compareIntegral(image);
+        if (pipeline) comparePipeline(image, iterations, precision);
+        if (roi) compareROI(image, iterations, precision);
+        if (incremental) compareIncremental(image, iterations, precision);
+        if (bufferPool) {
+            BufferPoolStats pool = BufferPool::global().getStats();
+            std::cout << "\nBufferPool: " << pool.requests << " alocacoes, reuso "
+                      << std::fixed << std::setprecision(1) << 100.0 * pool.reuseRate << "%, pico "
+                      << std::setprecision(1) << pool.highWaterMark / (1024.0 * 1024.0) << " MB\n";
+        }
 
         // Criar diretorio results se nao existir
         std::cerr << "Preparando para salvar CSV...\n" << std::flush;
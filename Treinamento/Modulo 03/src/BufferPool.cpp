@@ -0,0 +1,163 @@
+/**
+ * PAVIC LAB 2025 - BufferPool
+ * Alocador de cv::Mat que recicla buffers entre quadros
+ */
+
+#include "BufferPool.h"
+#include <algorithm>
+
+namespace pavic {
+
+BufferPool::BufferPool(size_t maxCachedBytes, size_t minPooledBytes)
+    : maxCached(maxCachedBytes), minPooled(std::max<size_t>(minPooledBytes, 1)) {}
+
+BufferPool::~BufferPool() {
+    if (installed) uninstall();
+    trim();
+}
+
+BufferPool& BufferPool::global() {
+    // Nunca destruída: Mats estáticos ou de outras threads podem morrer depois do fim de main
+    static BufferPool* pool = new BufferPool();
+    return *pool;
+}
+
+void BufferPool::install() {
+    if (installed) return;
+    previous = cv::Mat::getDefaultAllocator();
+    cv::Mat::setDefaultAllocator(this);
+    installed = true;
+}
+
+void BufferPool::uninstall() {
+    if (!installed) return;
+    cv::Mat::setDefaultAllocator(previous);
+    installed = false;
+}
+
+// Faixas: passos de 1/8 da maior potência de 2 <= size (64 KB, 72 KB, 80 KB, ..., 128 KB, 144 KB, ...)
+size_t BufferPool::bucketSize(size_t size) {
+    size_t power = 1;
+    while (power <= size / 2) power <<= 1;
+    size_t granule = std::max<size_t>(power / 8, 64);
+    return (size + granule - 1) / granule * granule;
+}
+
+uchar* BufferPool::acquire(size_t size) const {
+    if (size < minPooled) return static_cast<uchar*>(cv::fastMalloc(size));
+
+    size_t capacity = bucketSize(size);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.requests++;
+        stats.bytesInUse += capacity;
+        auto it = freeLists.find(capacity);
+        if (it != freeLists.end() && !it->second.empty()) {
+            uchar* data = it->second.back();
+            it->second.pop_back();
+            stats.bytesCached -= capacity;
+            stats.reused++;
+            return data;
+        }
+        stats.highWaterMark = std::max(stats.highWaterMark, stats.bytesInUse + stats.bytesCached);
+    }
+    // malloc fora da trava: as outras threads seguem reciclando enquanto o sistema aloca
+    return static_cast<uchar*>(cv::fastMalloc(capacity));
+}
+
+void BufferPool::release(uchar* data, size_t size) const {
+    if (size < minPooled) {
+        cv::fastFree(data);
+        return;
+    }
+
+    size_t capacity = bucketSize(size);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats.bytesInUse -= capacity;
+        if (stats.bytesCached + capacity <= maxCached) {
+            freeLists[capacity].push_back(data);
+            stats.bytesCached += capacity;
+            return;
+        }
+    }
+    cv::fastFree(data);
+}
+
+void BufferPool::evictUntil(size_t limit) const {
+    for (auto& bucket : freeLists) {
+        while (stats.bytesCached > limit && !bucket.second.empty()) {
+            cv::fastFree(bucket.second.back());
+            bucket.second.pop_back();
+            stats.bytesCached -= bucket.first;
+        }
+    }
+}
+
+void BufferPool::setMaxCachedBytes(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maxCached = bytes;
+    evictUntil(maxCached);
+}
+
+void BufferPool::trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    evictUntil(0);
+    freeLists.clear();
+}
+
+BufferPoolStats BufferPool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    BufferPoolStats result = stats;
+    result.reuseRate = result.requests > 0 ? static_cast<double>(result.reused) / result.requests : 0.0;
+    return result;
+}
+
+void BufferPool::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.requests = 0;
+    stats.reused = 0;
+    stats.highWaterMark = stats.bytesInUse + stats.bytesCached;
+}
+
+// Mesmo contrato do StdMatAllocator do OpenCV: passos contíguos calculados do último eixo para o
+// primeiro; com data0 a memória é do chamador e só o cabeçalho é criado
+cv::UMatData* BufferPool::allocate(int dims, const int* sizes, int type, void* data0, size_t* step,
+                                   cv::AccessFlag /*flags*/, cv::UMatUsageFlags /*usageFlags*/) const {
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = dims - 1; i >= 0; i--) {
+        if (step) {
+            if (data0 && step[i] != CV_AUTOSTEP) {
+                CV_Assert(total <= step[i]);
+                total = step[i];
+            } else {
+                step[i] = total;
+            }
+        }
+        total *= sizes[i];
+    }
+
+    uchar* data = data0 ? static_cast<uchar*>(data0) : acquire(total);
+    cv::UMatData* u = new cv::UMatData(this);
+    u->data = u->origdata = data;
+    u->size = total;
+    if (data0) u->flags |= cv::UMatData::USER_ALLOCATED;
+    return u;
+}
+
+bool BufferPool::allocate(cv::UMatData* u, cv::AccessFlag /*accessFlags*/, cv::UMatUsageFlags /*usageFlags*/) const {
+    return u != nullptr;
+}
+
+void BufferPool::deallocate(cv::UMatData* u) const {
+    if (!u) return;
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+    if (!(u->flags & cv::UMatData::USER_ALLOCATED)) {
+        release(u->origdata, u->size);
+        u->origdata = nullptr;
+    }
+    delete u;
+}
+
+} // namespace pavic
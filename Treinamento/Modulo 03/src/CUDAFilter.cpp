@@ -37,64 +37,138 @@ std::string getCUDADeviceName(int deviceId) {
 }
 
 // Todos os filtros usam a implementação sequencial como fallback
-cv::Mat grayscale(const cv::Mat& input) {
+void grayscale(const cv::Mat& input, cv::Mat& output) {
     showWarning();
-    return sequential::grayscale(input);
+    sequential::grayscale(input, output);
 }
 
-cv::Mat blur(const cv::Mat& input, int kernelSize) {
+void blur(const cv::Mat& input, cv::Mat& output, int kernelSize) {
     showWarning();
-    return sequential::blur(input, kernelSize);
+    sequential::blur(input, output, kernelSize);
 }
 
-cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize) {
+void gaussianBlur(const cv::Mat& input, cv::Mat& output, int kernelSize) {
     showWarning();
-    return sequential::gaussianBlur(input, kernelSize);
+    sequential::gaussianBlur(input, output, kernelSize);
 }
 
-cv::Mat sobel(const cv::Mat& input) {
+void sobel(const cv::Mat& input, cv::Mat& output) {
     showWarning();
-    return sequential::sobel(input);
+    sequential::sobel(input, output);
 }
 
-cv::Mat canny(const cv::Mat& input, double threshold1, double threshold2) {
+void canny(const cv::Mat& input, cv::Mat& output, double threshold1, double threshold2) {
     showWarning();
-    return sequential::canny(input, threshold1, threshold2);
+    sequential::canny(input, output, threshold1, threshold2);
 }
 
-cv::Mat sharpen(const cv::Mat& input) {
+void sharpen(const cv::Mat& input, cv::Mat& output) {
     showWarning();
-    return sequential::sharpen(input);
+    sequential::sharpen(input, output);
 }
 
-cv::Mat emboss(const cv::Mat& input) {
+void emboss(const cv::Mat& input, cv::Mat& output) {
     showWarning();
-    return sequential::emboss(input);
+    sequential::emboss(input, output);
 }
 
-cv::Mat negative(const cv::Mat& input) {
+void negative(const cv::Mat& input, cv::Mat& output) {
     showWarning();
-    return sequential::negative(input);
+    sequential::negative(input, output);
 }
 
-cv::Mat sepia(const cv::Mat& input) {
+void sepia(const cv::Mat& input, cv::Mat& output) {
     showWarning();
-    return sequential::sepia(input);
+    sequential::sepia(input, output);
 }
 
-cv::Mat threshold(const cv::Mat& input, int thresholdValue) {
+void threshold(const cv::Mat& input, cv::Mat& output, int thresholdValue) {
     showWarning();
-    return sequential::threshold(input, thresholdValue);
+    sequential::threshold(input, output, thresholdValue);
 }
 
-cv::Mat median(const cv::Mat& input, int kernelSize) {
+void median(const cv::Mat& input, cv::Mat& output, int kernelSize) {
     showWarning();
-    return sequential::median(input, kernelSize);
+    sequential::median(input, output, kernelSize);
 }
 
-cv::Mat bilateral(const cv::Mat& input, int d, double sigmaColor, double sigmaSpace) {
+void bilateral(const cv::Mat& input, cv::Mat& output, int d, double sigmaColor, double sigmaSpace) {
     showWarning();
-    return sequential::bilateral(input, d, sigmaColor, sigmaSpace);
+    sequential::bilateral(input, output, d, sigmaColor, sigmaSpace);
+}
+
+// Versões que devolvem uma imagem nova
+
+cv::Mat grayscale(const cv::Mat& input) {
+    cv::Mat output;
+    grayscale(input, output);
+    return output;
+}
+
+cv::Mat blur(const cv::Mat& input, int kernelSize) {
+    cv::Mat output;
+    blur(input, output, kernelSize);
+    return output;
+}
+
+cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize) {
+    cv::Mat output;
+    gaussianBlur(input, output, kernelSize);
+    return output;
+}
+
+cv::Mat sobel(const cv::Mat& input) {
+    cv::Mat output;
+    sobel(input, output);
+    return output;
+}
+
+cv::Mat canny(const cv::Mat& input, double threshold1, double threshold2) {
+    cv::Mat output;
+    canny(input, output, threshold1, threshold2);
+    return output;
+}
+
+cv::Mat sharpen(const cv::Mat& input) {
+    cv::Mat output;
+    sharpen(input, output);
+    return output;
+}
+
+cv::Mat emboss(const cv::Mat& input) {
+    cv::Mat output;
+    emboss(input, output);
+    return output;
+}
+
+cv::Mat negative(const cv::Mat& input) {
+    cv::Mat output;
+    negative(input, output);
+    return output;
+}
+
+cv::Mat sepia(const cv::Mat& input) {
+    cv::Mat output;
+    sepia(input, output);
+    return output;
+}
+
+cv::Mat threshold(const cv::Mat& input, int thresholdValue) {
+    cv::Mat output;
+    threshold(input, output, thresholdValue);
+    return output;
+}
+
+cv::Mat median(const cv::Mat& input, int kernelSize) {
+    cv::Mat output;
+    median(input, output, kernelSize);
+    return output;
+}
+
+cv::Mat bilateral(const cv::Mat& input, int d, double sigmaColor, double sigmaSpace) {
+    cv::Mat output;
+    bilateral(input, output, d, sigmaColor, sigmaSpace);
+    return output;
 }
 
 } // namespace cuda
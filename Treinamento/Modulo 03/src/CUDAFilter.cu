@@ -4,6 +4,7 @@
  */
 
 #include "CUDAFilter.h"
+#include "FilterUtils.h"
 #include <cuda_runtime.h>
 #include <device_launch_parameters.h>
 #include <iostream>
@@ -65,33 +66,54 @@ __global__ void thresholdKernel(const uchar3* input, unsigned char* output, int
     }
 }
 
-__global__ void blurKernel(const uchar3* input, uchar3* output, int width, int height, int kernelSize) {
+// Coeficientes do kernel separável (K taps por passe)
+#define MAX_SEPARABLE_TAPS 128
+__constant__ float c_separableKernel[MAX_SEPARABLE_TAPS];
+
+// Passe horizontal: uchar3 -> float3, borda replicada
+__global__ void separableRowKernel(const uchar3* input, float3* output, int width, int height, int kernelSize) {
+    int x = blockIdx.x * blockDim.x + threadIdx.x;
+    int y = blockIdx.y * blockDim.y + threadIdx.y;
+    
+    if (x < width && y < height) {
+        int half = kernelSize / 2;
+        float3 sum = make_float3(0.0f, 0.0f, 0.0f);
+        
+        for (int k = 0; k < kernelSize; ++k) {
+            int nx = min(max(x + k - half, 0), width - 1);
+            uchar3 pixel = input[y * width + nx];
+            float kv = c_separableKernel[k];
+            sum.x += pixel.x * kv;
+            sum.y += pixel.y * kv;
+            sum.z += pixel.z * kv;
+        }
+        
+        output[y * width + x] = sum;
+    }
+}
+
+// Passe vertical: float3 -> uchar3, borda replicada
+__global__ void separableColKernel(const float3* input, uchar3* output, int width, int height, int kernelSize) {
     int x = blockIdx.x * blockDim.x + threadIdx.x;
     int y = blockIdx.y * blockDim.y + threadIdx.y;
     
     if (x < width && y < height) {
         int half = kernelSize / 2;
         float3 sum = make_float3(0.0f, 0.0f, 0.0f);
-        int count = 0;
         
-        for (int ky = -half; ky <= half; ++ky) {
-            for (int kx = -half; kx <= half; ++kx) {
-                int nx = x + kx;
-                int ny = y + ky;
-                if (nx >= 0 && nx < width && ny >= 0 && ny < height) {
-                    uchar3 pixel = input[ny * width + nx];
-                    sum.x += pixel.x;
-                    sum.y += pixel.y;
-                    sum.z += pixel.z;
-                    count++;
-                }
-            }
+        for (int k = 0; k < kernelSize; ++k) {
+            int ny = min(max(y + k - half, 0), height - 1);
+            float3 v = input[ny * width + x];
+            float kv = c_separableKernel[k];
+            sum.x += v.x * kv;
+            sum.y += v.y * kv;
+            sum.z += v.z * kv;
         }
         
         output[y * width + x] = make_uchar3(
-            static_cast<unsigned char>(sum.x / count),
-            static_cast<unsigned char>(sum.y / count),
-            static_cast<unsigned char>(sum.z / count)
+            static_cast<unsigned char>(fminf(fmaxf(sum.x + 0.5f, 0.0f), 255.0f)),
+            static_cast<unsigned char>(fminf(fmaxf(sum.y + 0.5f, 0.0f), 255.0f)),
+            static_cast<unsigned char>(fminf(fmaxf(sum.z + 0.5f, 0.0f), 255.0f))
         );
     }
 }
@@ -127,9 +149,10 @@ std::string getCUDADeviceName(int deviceId) {
 
 // ============== Filter Implementations ==============
 
-cv::Mat grayscale(const cv::Mat& input) {
+void grayscale(const cv::Mat& input, cv::Mat& output) {
     if (!isCUDAAvailable() || input.empty()) {
-        return cv::Mat();
+        output.release();
+        return;
     }
     
     int width = input.cols;
@@ -137,7 +160,8 @@ cv::Mat grayscale(const cv::Mat& input) {
     
     cv::Mat inputBGR;
     if (input.channels() == 1) {
-        return input.clone();
+        input.copyTo(output);
+        return;
     }
     inputBGR = input;
     
@@ -158,20 +182,19 @@ cv::Mat grayscale(const cv::Mat& input) {
     dim3 grid((width + block.x - 1) / block.x, (height + block.y - 1) / block.y);
     grayscaleKernel<<<grid, block>>>(d_input, d_output, width, height);
     
-    // Copy result back
-    cv::Mat output(height, width, CV_8UC1);
-    cudaMemcpy(output.data, d_output, outputSize, cudaMemcpyDeviceToHost);
+    // Copy result back (output pode ser a própria entrada: ela já está na GPU)
+    output.create(height, width, CV_8UC1);
+    cudaMemcpy2D(output.data, output.step, d_output, width, width, height, cudaMemcpyDeviceToHost);
     
     // Free device memory
     cudaFree(d_input);
     cudaFree(d_output);
-    
-    return output;
 }
 
-cv::Mat negative(const cv::Mat& input) {
+void negative(const cv::Mat& input, cv::Mat& output) {
     if (!isCUDAAvailable() || input.empty()) {
-        return cv::Mat();
+        output.release();
+        return;
     }
     
     cv::Mat inputBGR;
@@ -196,18 +219,18 @@ cv::Mat negative(const cv::Mat& input) {
     dim3 grid((width + block.x - 1) / block.x, (height + block.y - 1) / block.y);
     negativeKernel<<<grid, block>>>(d_input, d_output, width, height);
     
-    cv::Mat output(height, width, CV_8UC3);
-    cudaMemcpy(output.data, d_output, size, cudaMemcpyDeviceToHost);
+    output.create(height, width, CV_8UC3);
+    cudaMemcpy2D(output.data, output.step, d_output, width * sizeof(uchar3), width * sizeof(uchar3), height,
+                 cudaMemcpyDeviceToHost);
     
     cudaFree(d_input);
     cudaFree(d_output);
-    
-    return output;
 }
 
-cv::Mat sepia(const cv::Mat& input) {
+void sepia(const cv::Mat& input, cv::Mat& output) {
     if (!isCUDAAvailable() || input.empty()) {
-        return cv::Mat();
+        output.release();
+        return;
     }
     
     cv::Mat inputBGR;
@@ -232,18 +255,18 @@ cv::Mat sepia(const cv::Mat& input) {
     dim3 grid((width + block.x - 1) / block.x, (height + block.y - 1) / block.y);
     sepiaKernel<<<grid, block>>>(d_input, d_output, width, height);
     
-    cv::Mat output(height, width, CV_8UC3);
-    cudaMemcpy(output.data, d_output, size, cudaMemcpyDeviceToHost);
+    output.create(height, width, CV_8UC3);
+    cudaMemcpy2D(output.data, output.step, d_output, width * sizeof(uchar3), width * sizeof(uchar3), height,
+                 cudaMemcpyDeviceToHost);
     
     cudaFree(d_input);
     cudaFree(d_output);
-    
-    return output;
 }
 
-cv::Mat threshold(const cv::Mat& input, int thresholdValue) {
+void threshold(const cv::Mat& input, cv::Mat& output, int thresholdValue) {
     if (!isCUDAAvailable() || input.empty()) {
-        return cv::Mat();
+        output.release();
+        return;
     }
     
     cv::Mat inputBGR;
@@ -267,18 +290,24 @@ cv::Mat threshold(const cv::Mat& input, int thresholdValue) {
     dim3 grid((width + block.x - 1) / block.x, (height + block.y - 1) / block.y);
     thresholdKernel<<<grid, block>>>(d_input, d_output, width, height, thresholdValue);
     
-    cv::Mat output(height, width, CV_8UC1);
-    cudaMemcpy(output.data, d_output, width * height, cudaMemcpyDeviceToHost);
+    output.create(height, width, CV_8UC1);
+    cudaMemcpy2D(output.data, output.step, d_output, width, width, height, cudaMemcpyDeviceToHost);
     
     cudaFree(d_input);
     cudaFree(d_output);
-    
-    return output;
 }
 
-cv::Mat blur(const cv::Mat& input, int kernelSize) {
+// Blur separável com o mesmo kernel 1D nos dois passes
+static void separableBlur(const cv::Mat& input, cv::Mat& output, const std::vector<double>& kernel) {
     if (!isCUDAAvailable() || input.empty()) {
-        return cv::Mat();
+        output.release();
+        return;
+    }
+    
+    int kernelSize = static_cast<int>(kernel.size());
+    if (kernelSize > MAX_SEPARABLE_TAPS) {
+        output.release();
+        return;
     }
     
     cv::Mat inputBGR;
@@ -291,35 +320,44 @@ cv::Mat blur(const cv::Mat& input, int kernelSize) {
     int width = inputBGR.cols;
     int height = inputBGR.rows;
     
+    std::vector<float> coeffs(kernel.begin(), kernel.end());
+    cudaMemcpyToSymbol(c_separableKernel, coeffs.data(), kernelSize * sizeof(float));
+    
     uchar3* d_input;
+    float3* d_temp;
     uchar3* d_output;
     size_t size = width * height * sizeof(uchar3);
     
     cudaMalloc(&d_input, size);
+    cudaMalloc(&d_temp, width * height * sizeof(float3));
     cudaMalloc(&d_output, size);
     cudaMemcpy(d_input, inputBGR.data, size, cudaMemcpyHostToDevice);
     
     dim3 block(16, 16);
     dim3 grid((width + block.x - 1) / block.x, (height + block.y - 1) / block.y);
-    blurKernel<<<grid, block>>>(d_input, d_output, width, height, kernelSize);
+    separableRowKernel<<<grid, block>>>(d_input, d_temp, width, height, kernelSize);
+    separableColKernel<<<grid, block>>>(d_temp, d_output, width, height, kernelSize);
     
-    cv::Mat output(height, width, CV_8UC3);
-    cudaMemcpy(output.data, d_output, size, cudaMemcpyDeviceToHost);
+    output.create(height, width, CV_8UC3);
+    cudaMemcpy2D(output.data, output.step, d_output, width * sizeof(uchar3), width * sizeof(uchar3), height,
+                 cudaMemcpyDeviceToHost);
     
     cudaFree(d_input);
+    cudaFree(d_temp);
     cudaFree(d_output);
-    
-    return output;
 }
 
-cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize) {
-    // Para Gaussian, usamos blur simples por enquanto (pode ser melhorado com kernel gaussiano)
-    return blur(input, kernelSize);
+void blur(const cv::Mat& input, cv::Mat& output, int kernelSize) {
+    separableBlur(input, output, utils::getBoxBlurKernel1D(kernelSize));
 }
 
-cv::Mat sobel(const cv::Mat& input) {
+void gaussianBlur(const cv::Mat& input, cv::Mat& output, int kernelSize) {
+    separableBlur(input, output, utils::getGaussianKernel1D(kernelSize));
+}
+
+void sobel(const cv::Mat& input, cv::Mat& output) {
     // Sobel é complexo em CUDA, usar OpenCV com GPU como fallback
-    if (!isCUDAAvailable() || input.empty()) return cv::Mat();
+    if (!isCUDAAvailable() || input.empty()) { output.release(); return; }
     
     cv::Mat gray;
     if (input.channels() == 3) {
@@ -328,18 +366,16 @@ cv::Mat sobel(const cv::Mat& input) {
         gray = input;
     }
     
-    cv::Mat gradX, gradY, output;
+    cv::Mat gradX, gradY;
     cv::Sobel(gray, gradX, CV_16S, 1, 0, 3);
     cv::Sobel(gray, gradY, CV_16S, 0, 1, 3);
     cv::convertScaleAbs(gradX, gradX);
     cv::convertScaleAbs(gradY, gradY);
     cv::addWeighted(gradX, 0.5, gradY, 0.5, 0, output);
-    
-    return output;
 }
 
-cv::Mat canny(const cv::Mat& input, double threshold1, double threshold2) {
-    if (!isCUDAAvailable() || input.empty()) return cv::Mat();
+void canny(const cv::Mat& input, cv::Mat& output, double threshold1, double threshold2) {
+    if (!isCUDAAvailable() || input.empty()) { output.release(); return; }
     
     cv::Mat gray;
     if (input.channels() == 3) {
@@ -348,22 +384,18 @@ cv::Mat canny(const cv::Mat& input, double threshold1, double threshold2) {
         gray = input;
     }
     
-    cv::Mat output;
-    cv::Canny(gray, output, threshold1, threshold2);
-    return output;
+    cv::Canny(utils::detachedInput(gray, output), output, threshold1, threshold2);
 }
 
-cv::Mat sharpen(const cv::Mat& input) {
-    if (!isCUDAAvailable() || input.empty()) return cv::Mat();
+void sharpen(const cv::Mat& input, cv::Mat& output) {
+    if (!isCUDAAvailable() || input.empty()) { output.release(); return; }
     
     cv::Mat blurred = blur(input, 5);
-    cv::Mat output;
     cv::addWeighted(input, 1.5, blurred, -0.5, 0, output);
-    return output;
 }
 
-cv::Mat emboss(const cv::Mat& input) {
-    if (!isCUDAAvailable() || input.empty()) return cv::Mat();
+void emboss(const cv::Mat& input, cv::Mat& output) {
+    if (!isCUDAAvailable() || input.empty()) { output.release(); return; }
     
     cv::Mat gray;
     if (input.channels() == 3) {
@@ -373,24 +405,93 @@ cv::Mat emboss(const cv::Mat& input) {
     }
     
     cv::Mat kernel = (cv::Mat_<float>(3,3) << -2, -1, 0, -1, 1, 1, 0, 1, 2);
-    cv::Mat output;
     cv::filter2D(gray, output, -1, kernel);
+}
+
+void median(const cv::Mat& input, cv::Mat& output, int kernelSize) {
+    if (!isCUDAAvailable() || input.empty()) { output.release(); return; }
+    
+    cv::medianBlur(utils::detachedInput(input, output), output, kernelSize);
+}
+
+void bilateral(const cv::Mat& input, cv::Mat& output, int d, double sigmaColor, double sigmaSpace) {
+    if (!isCUDAAvailable() || input.empty()) { output.release(); return; }
+    
+    // bilateralFilter não aceita a saída sobre a entrada
+    cv::bilateralFilter(utils::detachedInput(input, output), output, d, sigmaColor, sigmaSpace);
+}
+
+// Versões que devolvem uma imagem nova
+
+cv::Mat grayscale(const cv::Mat& input) {
+    cv::Mat output;
+    grayscale(input, output);
+    return output;
+}
+
+cv::Mat blur(const cv::Mat& input, int kernelSize) {
+    cv::Mat output;
+    blur(input, output, kernelSize);
+    return output;
+}
+
+cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize) {
+    cv::Mat output;
+    gaussianBlur(input, output, kernelSize);
+    return output;
+}
+
+cv::Mat sobel(const cv::Mat& input) {
+    cv::Mat output;
+    sobel(input, output);
+    return output;
+}
+
+cv::Mat canny(const cv::Mat& input, double threshold1, double threshold2) {
+    cv::Mat output;
+    canny(input, output, threshold1, threshold2);
+    return output;
+}
+
+cv::Mat sharpen(const cv::Mat& input) {
+    cv::Mat output;
+    sharpen(input, output);
+    return output;
+}
+
+cv::Mat emboss(const cv::Mat& input) {
+    cv::Mat output;
+    emboss(input, output);
+    return output;
+}
+
+cv::Mat negative(const cv::Mat& input) {
+    cv::Mat output;
+    negative(input, output);
+    return output;
+}
+
+cv::Mat sepia(const cv::Mat& input) {
+    cv::Mat output;
+    sepia(input, output);
+    return output;
+}
+
+cv::Mat threshold(const cv::Mat& input, int thresholdValue) {
+    cv::Mat output;
+    threshold(input, output, thresholdValue);
     return output;
 }
 
 cv::Mat median(const cv::Mat& input, int kernelSize) {
-    if (!isCUDAAvailable() || input.empty()) return cv::Mat();
-    
     cv::Mat output;
-    cv::medianBlur(input, output, kernelSize);
+    median(input, output, kernelSize);
     return output;
 }
 
 cv::Mat bilateral(const cv::Mat& input, int d, double sigmaColor, double sigmaSpace) {
-    if (!isCUDAAvailable() || input.empty()) return cv::Mat();
-    
     cv::Mat output;
-    cv::bilateralFilter(input, output, d, sigmaColor, sigmaSpace);
+    bilateral(input, output, d, sigmaColor, sigmaSpace);
     return output;
 }
 
@@ -4,14 +4,38 @@
  */
 
 #include "FilterUtils.h"
+#include "ConvolutionKernels.h"
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+// SSE2 faz parte de toda CPU x86-64, então não exige flags de compilação
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define PAVIC_MEDIAN_SSE2 1
+#include <emmintrin.h>
+#endif
 
 namespace pavic {
 namespace utils {
 
+double getGaussianSigma(int size) {
+    return 0.3 * ((size - 1) * 0.5 - 1) + 0.8;
+}
+
 cv::Mat getGaussianKernel(int size, double sigma) {
     if (sigma <= 0) {
-        sigma = 0.3 * ((size - 1) * 0.5 - 1) + 0.8;
+        sigma = getGaussianSigma(size);
     }
     
     cv::Mat kernel(size, size, CV_64F);
@@ -33,36 +57,30 @@ cv::Mat getGaussianKernel(int size, double sigma) {
     return kernel;
 }
 
-cv::Mat getSharpenKernel() {
-    cv::Mat kernel = (cv::Mat_<double>(3, 3) <<
-        0, -1, 0,
-        -1, 5, -1,
-        0, -1, 0);
+// Versão cv::Mat (double) dos kernels embutidos, para os caminhos genéricos
+template <typename Kernel>
+static cv::Mat builtinKernelMat() {
+    cv::Mat kernel(Kernel::size, Kernel::size, CV_64F);
+    for (int i = 0; i < Kernel::size * Kernel::size; i++) {
+        kernel.at<double>(i / Kernel::size, i % Kernel::size) = Kernel::weights[i];
+    }
     return kernel;
 }
 
+cv::Mat getSharpenKernel() {
+    return builtinKernelMat<SharpenKernel3>();
+}
+
 cv::Mat getEmbossKernel() {
-    cv::Mat kernel = (cv::Mat_<double>(3, 3) <<
-        -2, -1, 0,
-        -1, 1, 1,
-        0, 1, 2);
-    return kernel;
+    return builtinKernelMat<EmbossKernel3>();
 }
 
 cv::Mat getSobelKernelX() {
-    cv::Mat kernel = (cv::Mat_<double>(3, 3) <<
-        -1, 0, 1,
-        -2, 0, 2,
-        -1, 0, 1);
-    return kernel;
+    return builtinKernelMat<SobelXKernel3>();
 }
 
 cv::Mat getSobelKernelY() {
-    cv::Mat kernel = (cv::Mat_<double>(3, 3) <<
-        -1, -2, -1,
-        0, 0, 0,
-        1, 2, 1);
-    return kernel;
+    return builtinKernelMat<SobelYKernel3>();
 }
 
 cv::Mat getBoxBlurKernel(int size) {
@@ -71,6 +89,1396 @@ cv::Mat getBoxBlurKernel(int size) {
     return kernel;
 }
 
+std::vector<double> getGaussianKernel1D(int size, double sigma) {
+    if (sigma <= 0) {
+        sigma = getGaussianSigma(size);
+    }
+    
+    // O kernel 2D de getGaussianKernel é o produto externo deste vetor por ele mesmo
+    std::vector<double> kernel(size);
+    int half = size / 2;
+    double sum = 0.0;
+    
+    for (int i = 0; i < size; i++) {
+        int x = i - half;
+        kernel[i] = exp(-(x * x) / (2 * sigma * sigma));
+        sum += kernel[i];
+    }
+    
+    for (double& v : kernel) v /= sum;
+    return kernel;
+}
+
+std::vector<double> getBoxBlurKernel1D(int size) {
+    return std::vector<double>(size, 1.0 / size);
+}
+
+// Young & van Vliet, "Recursive implementation of the Gaussian filter" (1995)
+RecursiveGaussianCoeffs makeRecursiveGaussianCoeffs(double sigma) {
+    sigma = std::max(sigma, 0.5);
+    double q = sigma >= 2.5 ? 0.98711 * sigma - 0.96330 : 3.97156 - 4.14554 * std::sqrt(1.0 - 0.26891 * sigma);
+    double q2 = q * q, q3 = q2 * q;
+    double b0 = 1.57825 + 2.44413 * q + 1.4281 * q2 + 0.422205 * q3;
+    double b1 = 2.44413 * q + 2.85619 * q2 + 1.26661 * q3;
+    double b2 = -(1.4281 * q2 + 1.26661 * q3);
+    double b3 = 0.422205 * q3;
+    
+    double a1 = b1 / b0, a2 = b2 / b0, a3 = b3 / b0, b = 1.0 - (a1 + a2 + a3);
+    
+    RecursiveGaussianCoeffs coeffs;
+    coeffs.a1 = static_cast<float>(a1);
+    coeffs.a2 = static_cast<float>(a2);
+    coeffs.a3 = static_cast<float>(a3);
+    coeffs.b = static_cast<float>(b);
+    
+    // Com borda replicada, o estado anticausal em N, N+1, N+2 é linear no desvio dos três últimos
+    // valores causais em relação à borda (Triggs & Sdika, 2006). A matriz é obtida propagando cada
+    // desvio unitário até ele se extinguir (a resposta decai em poucos sigmas).
+    int len = static_cast<int>(10 * sigma) + 30;
+    std::vector<double> tail(len);
+    for (int k = 0; k < 3; k++) {
+        double w[3] = {0, 0, 0};
+        w[k] = 1;
+        for (int j = 0; j < len; j++) {
+            double v = a1 * w[0] + a2 * w[1] + a3 * w[2];
+            tail[j] = v;
+            w[2] = w[1]; w[1] = w[0]; w[0] = v;
+        }
+        double y1 = 0, y2 = 0, y3 = 0;
+        for (int j = len - 1; j >= 0; j--) {
+            double v = b * tail[j] + a1 * y1 + a2 * y2 + a3 * y3;
+            if (j < 3) coeffs.m[j][k] = static_cast<float>(v);
+            y3 = y2; y2 = y1; y1 = v;
+        }
+    }
+    return coeffs;
+}
+
+static std::atomic<int> recursiveGaussianThreshold{15};
+
+void setRecursiveGaussianThreshold(int kernelSize) {
+    recursiveGaussianThreshold = kernelSize;
+}
+
+int getRecursiveGaussianThreshold() {
+    return recursiveGaussianThreshold;
+}
+
+bool useRecursiveGaussian(int kernelSize) {
+    return kernelSize > recursiveGaussianThreshold;
+}
+
+std::string getPrecisionName(Precision precision) {
+    switch (precision) {
+        case Precision::DOUBLE: return "Double";
+        case Precision::FLOAT32: return "Float32";
+        case Precision::FIXED_POINT: return "FixedPoint";
+    }
+    return "Unknown";
+}
+
+static int toFixed(double w, int shift) {
+    return static_cast<int>(std::lround(w * (1 << shift)));
+}
+
+// Arredonda um acumulador em ponto fixo de volta para 8 bits
+template <typename T>
+static uchar fromFixed(T acc, int shift) {
+    return cv::saturate_cast<uchar>(static_cast<int64_t>((acc + (T(1) << (shift - 1))) >> shift));
+}
+
+template <int K, typename T, typename Store>
+static bool convolveRowsK(const cv::Mat& padded, cv::Mat& output, const T* w, int rowStart, int rowEnd, Store store) {
+    switch (output.channels()) {
+        case 1: convolveRowsFixedSize<K, 1>(padded, output, w, rowStart, rowEnd, store); return true;
+        case 3: convolveRowsFixedSize<K, 3>(padded, output, w, rowStart, rowEnd, store); return true;
+    }
+    return false;
+}
+
+// Encaminha tamanhos comuns para laços com tamanho fixo; false = usar o laço genérico
+template <typename T, typename Store>
+static bool convolveRowsSpecialized(const cv::Mat& padded, cv::Mat& output, const cv::Mat& kernel, const T* w,
+                                    int rowStart, int rowEnd, Store store) {
+    if (kernel.rows != kernel.cols) return false;
+    switch (kernel.rows) {
+        case 3: return convolveRowsK<3>(padded, output, w, rowStart, rowEnd, store);
+        case 5: return convolveRowsK<5>(padded, output, w, rowStart, rowEnd, store);
+        case 7: return convolveRowsK<7>(padded, output, w, rowStart, rowEnd, store);
+    }
+    return false;
+}
+
+template <typename T>
+static void convolveRowsFloat(const cv::Mat& padded, cv::Mat& output, const cv::Mat& kernel, int rowStart, int rowEnd) {
+    int kRows = kernel.rows, kCols = kernel.cols;
+    int cn = output.channels(), rowLen = output.cols * cn;
+    std::vector<T> w(kRows * kCols);
+    for (int ki = 0; ki < kRows; ki++)
+        for (int kj = 0; kj < kCols; kj++) w[ki * kCols + kj] = static_cast<T>(kernel.at<double>(ki, kj));
+
+    auto store = [](T v) { return cv::saturate_cast<uchar>(v); };
+    if (convolveRowsSpecialized(padded, output, kernel, w.data(), rowStart, rowEnd, store)) return;
+
+    for (int i = rowStart; i < rowEnd; i++) {
+        uchar* dst = output.ptr<uchar>(i);
+        for (int j = 0; j < rowLen; j++) {
+            T sum = 0;
+            for (int ki = 0; ki < kRows; ki++) {
+                const uchar* src = padded.ptr<uchar>(i + ki) + j;
+                for (int kj = 0; kj < kCols; kj++) sum += src[kj * cn] * w[ki * kCols + kj];
+            }
+            dst[j] = cv::saturate_cast<uchar>(sum);
+        }
+    }
+}
+
+static void convolveRowsFixed(const cv::Mat& padded, cv::Mat& output, const cv::Mat& kernel, int rowStart, int rowEnd) {
+    int kRows = kernel.rows, kCols = kernel.cols;
+    int cn = output.channels(), rowLen = output.cols * cn;
+    std::vector<int> w(kRows * kCols);
+    for (int ki = 0; ki < kRows; ki++)
+        for (int kj = 0; kj < kCols; kj++) w[ki * kCols + kj] = toFixed(kernel.at<double>(ki, kj), kFixedShift);
+
+    auto store = [](int v) { return fromFixed(v, kFixedShift); };
+    if (convolveRowsSpecialized(padded, output, kernel, w.data(), rowStart, rowEnd, store)) return;
+
+    for (int i = rowStart; i < rowEnd; i++) {
+        uchar* dst = output.ptr<uchar>(i);
+        for (int j = 0; j < rowLen; j++) {
+            int sum = 0;
+            for (int ki = 0; ki < kRows; ki++) {
+                const uchar* src = padded.ptr<uchar>(i + ki) + j;
+                for (int kj = 0; kj < kCols; kj++) sum += src[kj * cn] * w[ki * kCols + kj];
+            }
+            dst[j] = fromFixed(sum, kFixedShift);
+        }
+    }
+}
+
+void convolveRows(const cv::Mat& padded, cv::Mat& output, const cv::Mat& kernel,
+                  int rowStart, int rowEnd, Precision precision) {
+    switch (precision) {
+        case Precision::DOUBLE: convolveRowsFloat<double>(padded, output, kernel, rowStart, rowEnd); break;
+        case Precision::FLOAT32: convolveRowsFloat<float>(padded, output, kernel, rowStart, rowEnd); break;
+        case Precision::FIXED_POINT: convolveRowsFixed(padded, output, kernel, rowStart, rowEnd); break;
+    }
+}
+
+template <typename Kernel>
+static void convolveBuiltin(const cv::Mat& padded, cv::Mat& output, int rowStart, int rowEnd) {
+    if (output.channels() == 1) convolveBuiltinRows<Kernel, 1>(padded, output, rowStart, rowEnd);
+    else convolveBuiltinRows<Kernel, 3>(padded, output, rowStart, rowEnd);
+}
+
+void convolveRows(const cv::Mat& padded, cv::Mat& output, BuiltinKernel kernel, int rowStart, int rowEnd) {
+    switch (kernel) {
+        case BuiltinKernel::SHARPEN: convolveBuiltin<SharpenKernel3>(padded, output, rowStart, rowEnd); break;
+        case BuiltinKernel::EMBOSS: convolveBuiltin<EmbossKernel3>(padded, output, rowStart, rowEnd); break;
+        case BuiltinKernel::SOBEL_X: convolveBuiltin<SobelXKernel3>(padded, output, rowStart, rowEnd); break;
+        case BuiltinKernel::SOBEL_Y: convolveBuiltin<SobelYKernel3>(padded, output, rowStart, rowEnd); break;
+    }
+}
+
+int separableBufferDepth(Precision precision) {
+    switch (precision) {
+        case Precision::FLOAT32: return CV_32F;
+        case Precision::FIXED_POINT: return CV_32S;
+        default: return CV_64F;
+    }
+}
+
+// Passe horizontal: resultado intermediário sem arredondar (ponto fixo fica em Q14)
+template <typename T, typename W>
+static void rowPass(const cv::Mat& paddedX, cv::Mat& temp, const std::vector<W>& w, int rowStart, int rowEnd) {
+    int k = static_cast<int>(w.size());
+    int cn = temp.channels(), rowLen = temp.cols * cn;
+    for (int i = rowStart; i < rowEnd; i++) {
+        const uchar* src = paddedX.ptr<uchar>(i);
+        T* dst = temp.ptr<T>(i);
+        for (int j = 0; j < rowLen; j++) {
+            T sum = 0;
+            for (int q = 0; q < k; q++) sum += src[j + q * cn] * w[q];
+            dst[j] = sum;
+        }
+    }
+}
+
+// Passe vertical: acumula linha a linha para percorrer a memória de forma contígua
+template <typename T, typename A, typename W, typename Store>
+static void columnPass(const cv::Mat& paddedY, cv::Mat& output, const std::vector<W>& w,
+                       int rowStart, int rowEnd, Store store) {
+    int k = static_cast<int>(w.size());
+    int rowLen = output.cols * output.channels();
+    std::vector<A> acc(rowLen);
+    for (int i = rowStart; i < rowEnd; i++) {
+        std::fill(acc.begin(), acc.end(), A(0));
+        for (int q = 0; q < k; q++) {
+            const T* src = paddedY.ptr<T>(i + q);
+            A kv = w[q];
+            for (int j = 0; j < rowLen; j++) acc[j] += src[j] * kv;
+        }
+        uchar* dst = output.ptr<uchar>(i);
+        for (int j = 0; j < rowLen; j++) dst[j] = store(acc[j]);
+    }
+}
+
+void separableRowPass(const cv::Mat& paddedX, cv::Mat& temp, const std::vector<double>& kernelX,
+                      int rowStart, int rowEnd, Precision precision) {
+    switch (precision) {
+        case Precision::DOUBLE:
+            rowPass<double>(paddedX, temp, kernelX, rowStart, rowEnd);
+            break;
+        case Precision::FLOAT32:
+            rowPass<float>(paddedX, temp, std::vector<float>(kernelX.begin(), kernelX.end()), rowStart, rowEnd);
+            break;
+        case Precision::FIXED_POINT: {
+            std::vector<int> w(kernelX.size());
+            for (size_t q = 0; q < w.size(); q++) w[q] = toFixed(kernelX[q], kFixedShift);
+            rowPass<int>(paddedX, temp, w, rowStart, rowEnd);
+            break;
+        }
+    }
+}
+
+void separableColumnPass(const cv::Mat& paddedY, cv::Mat& output, const std::vector<double>& kernelY,
+                         int rowStart, int rowEnd, Precision precision) {
+    switch (precision) {
+        case Precision::DOUBLE:
+            columnPass<double, double>(paddedY, output, kernelY, rowStart, rowEnd,
+                                       [](double v) { return cv::saturate_cast<uchar>(v); });
+            break;
+        case Precision::FLOAT32:
+            columnPass<float, float>(paddedY, output, std::vector<float>(kernelY.begin(), kernelY.end()), rowStart, rowEnd,
+                                     [](float v) { return cv::saturate_cast<uchar>(v); });
+            break;
+        case Precision::FIXED_POINT: {
+            // Q14 x Q14 = Q28: acumula em 64 bits
+            std::vector<int> w(kernelY.size());
+            for (size_t q = 0; q < w.size(); q++) w[q] = toFixed(kernelY[q], kFixedShift);
+            columnPass<int, int64_t>(paddedY, output, w, rowStart, rowEnd,
+                                     [](int64_t v) { return fromFixed(v, 2 * kFixedShift); });
+            break;
+        }
+    }
+}
+
+void grayscaleRows(const cv::Mat& input, cv::Mat& output, int rowStart, int rowEnd, Precision precision) {
+    static const ColorMatrix gray = makeGrayscaleMatrix();
+    colorMatrixRows(input, output, gray, rowStart, rowEnd, precision);
+}
+
+void sepiaRows(const cv::Mat& input, cv::Mat& output, int rowStart, int rowEnd, Precision precision) {
+    static const ColorMatrix sepia = makeSepiaMatrix();
+    colorMatrixRows(input, output, sepia, rowStart, rowEnd, precision);
+}
+
+PointwiseLut makeIdentityLut() {
+    return makeLut([](int v) { return v; });
+}
+
+PointwiseLut makeNegativeLut() {
+    return makeLut([](int v) { return 255 - v; });
+}
+
+PointwiseLut makeThresholdLut(int thresholdValue) {
+    return makeLut([thresholdValue](int v) { return v > thresholdValue ? 255 : 0; });
+}
+
+PointwiseLut makeBiasLut(int offset) {
+    return makeLut([offset](int v) { return v + offset; });
+}
+
+PointwiseLut makeContrastLut(double alpha, double beta) {
+    return makeLut([alpha, beta](int v) { return alpha * v + beta; });
+}
+
+PointwiseLut makeGammaLut(double gamma) {
+    return makeLut([gamma](int v) { return 255.0 * std::pow(v / 255.0, gamma); });
+}
+
+PointwiseLut composeLut(const PointwiseLut& first, const PointwiseLut& second) {
+    PointwiseLut lut;
+    for (int v = 0; v < 256; v++) lut.table[v] = second.table[first.table[v]];
+    return lut;
+}
+
+// Uma leitura de tabela por byte, desenrolada em 4 para sobrepor as cargas
+void applyLutRows(const cv::Mat& input, cv::Mat& output, const PointwiseLut& lut, int rowStart, int rowEnd) {
+    const uchar* table = lut.table;
+    int rowLen = input.cols * input.channels();
+    for (int i = rowStart; i < rowEnd; i++) {
+        const uchar* src = input.ptr<uchar>(i);
+        uchar* dst = output.ptr<uchar>(i);
+        int j = 0;
+        for (; j + 4 <= rowLen; j += 4) {
+            uchar a = table[src[j]], b = table[src[j + 1]], c = table[src[j + 2]], d = table[src[j + 3]];
+            dst[j] = a;
+            dst[j + 1] = b;
+            dst[j + 2] = c;
+            dst[j + 3] = d;
+        }
+        for (; j < rowLen; j++) dst[j] = table[src[j]];
+    }
+}
+
+ColorMatrix makeColorMatrix(const double (&coeffs)[3][3], int outChannels) {
+    ColorMatrix m;
+    m.outChannels = outChannels;
+    m.inRange = true;
+    for (int c = 0; c < 3; c++) {
+        double sum = 0;
+        int fixedSum = 0;
+        for (int k = 0; k < 3; k++) {
+            m.coeffs[c][k] = coeffs[c][k];
+            m.coeffsF[c][k] = static_cast<float>(coeffs[c][k]);
+            m.fixed[c][k] = toFixed(coeffs[c][k], kFixedShift);
+            if (coeffs[c][k] < 0 || m.fixed[c][k] < 0) m.inRange = false;
+            sum += coeffs[c][k];
+            fixedSum += m.fixed[c][k];
+        }
+        // Folga para o arredondamento em double/float; Q14 verificado exatamente
+        if (c < outChannels && (sum * 255 >= 255.5 || ((fixedSum * 255) >> kFixedShift) > 255)) m.inRange = false;
+    }
+    return m;
+}
+
+ColorMatrix makeGrayscaleMatrix() {
+    const double gray[3][3] = {{0.299, 0.587, 0.114}};
+    return makeColorMatrix(gray, 1);
+}
+
+ColorMatrix makeSepiaMatrix() {
+    const double sepia[3][3] = {{0.272, 0.534, 0.131}, {0.349, 0.686, 0.168}, {0.393, 0.769, 0.189}};
+    return makeColorMatrix(sepia, 3);
+}
+
+ColorMatrix makeChannelSwapMatrix() {
+    const double swap[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+    return makeColorMatrix(swap, 3);
+}
+
+// OUT canais de saída; dot(c, r, g, b) devolve o valor inteiro já truncado do canal c
+template <int OUT, bool SATURATE, bool WITH_LUT, typename Dot>
+static void colorMatrixLoop(const cv::Mat& input, cv::Mat& output, int rowStart, int rowEnd,
+                            const uchar* table, Dot dot) {
+    for (int i = rowStart; i < rowEnd; i++) {
+        const uchar* src = input.ptr<uchar>(i);
+        uchar* dst = output.ptr<uchar>(i);
+        for (int j = 0; j < input.cols; j++, src += 3, dst += OUT) {
+            int b = src[0], g = src[1], r = src[2];
+            for (int c = 0; c < OUT; c++) {
+                uchar v = SATURATE ? cv::saturate_cast<uchar>(dot(c, r, g, b)) : static_cast<uchar>(dot(c, r, g, b));
+                dst[c] = WITH_LUT ? table[v] : v;
+            }
+        }
+    }
+}
+
+template <int OUT, bool SATURATE, typename Dot>
+static void colorMatrixLoop(const cv::Mat& input, cv::Mat& output, int rowStart, int rowEnd,
+                            const PointwiseLut* lut, Dot dot) {
+    if (lut) colorMatrixLoop<OUT, SATURATE, true>(input, output, rowStart, rowEnd, lut->table, dot);
+    else colorMatrixLoop<OUT, SATURATE, false>(input, output, rowStart, rowEnd, nullptr, dot);
+}
+
+template <typename Dot>
+static void colorMatrixDispatch(const cv::Mat& input, cv::Mat& output, const ColorMatrix& matrix,
+                                int rowStart, int rowEnd, const PointwiseLut* lut, Dot dot) {
+    bool saturate = !matrix.inRange;
+    if (matrix.outChannels == 1) {
+        if (saturate) colorMatrixLoop<1, true>(input, output, rowStart, rowEnd, lut, dot);
+        else colorMatrixLoop<1, false>(input, output, rowStart, rowEnd, lut, dot);
+    } else {
+        if (saturate) colorMatrixLoop<3, true>(input, output, rowStart, rowEnd, lut, dot);
+        else colorMatrixLoop<3, false>(input, output, rowStart, rowEnd, lut, dot);
+    }
+}
+
+void colorMatrixRows(const cv::Mat& input, cv::Mat& output, const ColorMatrix& matrix,
+                     int rowStart, int rowEnd, Precision precision, const PointwiseLut* lut) {
+    switch (precision) {
+        case Precision::DOUBLE: {
+            const auto& m = matrix.coeffs;
+            colorMatrixDispatch(input, output, matrix, rowStart, rowEnd, lut, [m](int c, int r, int g, int b) {
+                return static_cast<int>(m[c][0] * r + m[c][1] * g + m[c][2] * b);
+            });
+            break;
+        }
+        case Precision::FLOAT32: {
+            const auto& m = matrix.coeffsF;
+            colorMatrixDispatch(input, output, matrix, rowStart, rowEnd, lut, [m](int c, int r, int g, int b) {
+                return static_cast<int>(m[c][0] * r + m[c][1] * g + m[c][2] * b);
+            });
+            break;
+        }
+        case Precision::FIXED_POINT: {
+            const auto& m = matrix.fixed;
+            colorMatrixDispatch(input, output, matrix, rowStart, rowEnd, lut, [m](int c, int r, int g, int b) {
+                return (m[c][0] * r + m[c][1] * g + m[c][2] * b) >> kFixedShift;
+            });
+            break;
+        }
+    }
+}
+
+BilateralWeights makeBilateralWeights(int d, double sigmaColor, double sigmaSpace, Precision precision) {
+    BilateralWeights w;
+    w.d = d;
+    w.precision = precision;
+    int radius = d / 2;
+    w.spatial.resize(d * d);
+    for (int i = 0; i < d; i++) {
+        for (int j = 0; j < d; j++) {
+            int dx = i - radius, dy = j - radius;
+            w.spatial[i * d + j] = std::exp(-(dx * dx + dy * dy) / (2 * sigmaSpace * sigmaSpace));
+        }
+    }
+    // A diferença de cor entre dois uchar só assume 256 valores absolutos: tabela em vez de exp por vizinho
+    w.color.resize(256);
+    for (int diff = 0; diff < 256; diff++) {
+        double cd = diff;
+        w.color[diff] = std::exp(-(cd * cd) / (2 * sigmaColor * sigmaColor));
+    }
+    w.spatialF.assign(w.spatial.begin(), w.spatial.end());
+    w.colorF.assign(w.color.begin(), w.color.end());
+    for (double v : w.spatial) w.spatialQ.push_back(toFixed(v, 15));
+    for (double v : w.color) w.colorQ.push_back(toFixed(v, 15));
+    return w;
+}
+
+template <typename T>
+static void bilateralRowsFloat(const cv::Mat& padded, cv::Mat& output, int d,
+                               const std::vector<T>& spatial, const std::vector<T>& color, int rowStart, int rowEnd) {
+    int radius = d / 2;
+    int cn = output.channels(), rowLen = output.cols * cn;
+    for (int i = rowStart; i < rowEnd; i++) {
+        const uchar* center = padded.ptr<uchar>(i + radius) + radius * cn;
+        uchar* dst = output.ptr<uchar>(i);
+        for (int j = 0; j < rowLen; j++) {
+            T sumWeight = 0, sumValue = 0;
+            for (int ki = 0; ki < d; ki++) {
+                const uchar* src = padded.ptr<uchar>(i + ki) + j;
+                for (int kj = 0; kj < d; kj++) {
+                    uchar n = src[kj * cn];
+                    T weight = spatial[ki * d + kj] * color[std::abs(center[j] - n)];
+                    sumWeight += weight;
+                    sumValue += weight * n;
+                }
+            }
+            dst[j] = cv::saturate_cast<uchar>(sumValue / sumWeight);
+        }
+    }
+}
+
+static void bilateralRowsFixed(const cv::Mat& padded, cv::Mat& output, const BilateralWeights& w, int rowStart, int rowEnd) {
+    int d = w.d, radius = d / 2;
+    int cn = output.channels(), rowLen = output.cols * cn;
+    for (int i = rowStart; i < rowEnd; i++) {
+        const uchar* center = padded.ptr<uchar>(i + radius) + radius * cn;
+        uchar* dst = output.ptr<uchar>(i);
+        for (int j = 0; j < rowLen; j++) {
+            int64_t sumWeight = 0, sumValue = 0;
+            for (int ki = 0; ki < d; ki++) {
+                const uchar* src = padded.ptr<uchar>(i + ki) + j;
+                for (int kj = 0; kj < d; kj++) {
+                    uchar n = src[kj * cn];
+                    // Q15 x Q15 -> Q15 (o peso central vale 1.0 = 32768, então sumWeight > 0)
+                    int weight = (w.spatialQ[ki * d + kj] * w.colorQ[std::abs(center[j] - n)] + (1 << 14)) >> 15;
+                    sumWeight += weight;
+                    sumValue += static_cast<int64_t>(weight) * n;
+                }
+            }
+            dst[j] = cv::saturate_cast<uchar>((sumValue + sumWeight / 2) / sumWeight);
+        }
+    }
+}
+
+void bilateralRows(const cv::Mat& padded, cv::Mat& output, const BilateralWeights& weights,
+                   int rowStart, int rowEnd) {
+    switch (weights.precision) {
+        case Precision::DOUBLE:
+            bilateralRowsFloat(padded, output, weights.d, weights.spatial, weights.color, rowStart, rowEnd);
+            break;
+        case Precision::FLOAT32:
+            bilateralRowsFloat(padded, output, weights.d, weights.spatialF, weights.colorF, rowStart, rowEnd);
+            break;
+        case Precision::FIXED_POINT:
+            bilateralRowsFixed(padded, output, weights, rowStart, rowEnd);
+            break;
+    }
+}
+
+// Estado inicial do passe anticausal a partir dos três últimos valores causais e do valor da borda
+static inline void anticausalInit(const RecursiveGaussianCoeffs& c, float u, float w1, float w2, float w3,
+                                  float& y1, float& y2, float& y3) {
+    float d1 = w1 - u, d2 = w2 - u, d3 = w3 - u;
+    y1 = u + c.m[0][0] * d1 + c.m[0][1] * d2 + c.m[0][2] * d3;
+    y2 = u + c.m[1][0] * d1 + c.m[1][1] * d2 + c.m[1][2] * d3;
+    y3 = u + c.m[2][0] * d1 + c.m[2][1] * d2 + c.m[2][2] * d3;
+}
+
+// Borda BORDER_REPLICATE: o passe causal parte do estado de um sinal constante igual ao primeiro
+// valor; o anticausal, do estado exato da extensão constante do último (anticausalInit)
+void recursiveGaussianRowPass(const cv::Mat& input, cv::Mat& temp, const RecursiveGaussianCoeffs& coeffs,
+                              int rowStart, int rowEnd) {
+    const float b = coeffs.b, a1 = coeffs.a1, a2 = coeffs.a2, a3 = coeffs.a3;
+    int cn = input.channels(), n = input.cols;
+    std::vector<float> line(n);
+    for (int i = rowStart; i < rowEnd; i++) {
+        const uchar* src = input.ptr<uchar>(i);
+        float* dst = temp.ptr<float>(i);
+        for (int c = 0; c < cn; c++) {
+            float w1 = src[c], w2 = w1, w3 = w1;
+            for (int j = 0; j < n; j++) {
+                float w = b * src[j * cn + c] + a1 * w1 + a2 * w2 + a3 * w3;
+                line[j] = w;
+                w3 = w2; w2 = w1; w1 = w;
+            }
+            float y1, y2, y3;
+            anticausalInit(coeffs, src[(n - 1) * cn + c], w1, w2, w3, y1, y2, y3);
+            for (int j = n - 1; j >= 0; j--) {
+                float y = b * line[j] + a1 * y1 + a2 * y2 + a3 * y3;
+                dst[j * cn + c] = y;
+                y3 = y2; y2 = y1; y1 = y;
+            }
+        }
+    }
+}
+
+// Percorre as linhas inteiras de [colStart, colEnd) em vez de descer coluna a coluna
+void recursiveGaussianColumnPass(cv::Mat& temp, cv::Mat& output, const RecursiveGaussianCoeffs& coeffs,
+                                 int colStart, int colEnd) {
+    const float b = coeffs.b, a1 = coeffs.a1, a2 = coeffs.a2, a3 = coeffs.a3;
+    int n = colEnd - colStart, rows = temp.rows;
+    if (n <= 0) return;
+    
+    const float* first = temp.ptr<float>(0) + colStart;
+    const float* last = temp.ptr<float>(rows - 1) + colStart;
+    std::vector<float> s1(first, first + n), s2(s1), s3(s1);
+    std::vector<float> edge(last, last + n);   // entrada da última linha, antes de ser sobrescrita
+    for (int i = 0; i < rows; i++) {
+        float* row = temp.ptr<float>(i) + colStart;
+        for (int j = 0; j < n; j++) {
+            float w = b * row[j] + a1 * s1[j] + a2 * s2[j] + a3 * s3[j];
+            s3[j] = s2[j]; s2[j] = s1[j]; s1[j] = w;
+            row[j] = w;
+        }
+    }
+    
+    for (int j = 0; j < n; j++) anticausalInit(coeffs, edge[j], s1[j], s2[j], s3[j], s1[j], s2[j], s3[j]);
+    for (int i = rows - 1; i >= 0; i--) {
+        const float* row = temp.ptr<float>(i) + colStart;
+        uchar* dst = output.ptr<uchar>(i) + colStart;
+        for (int j = 0; j < n; j++) {
+            float y = b * row[j] + a1 * s1[j] + a2 * s2[j] + a3 * s3[j];
+            s3[j] = s2[j]; s2[j] = s1[j]; s1[j] = y;
+            dst[j] = cv::saturate_cast<uchar>(y);
+        }
+    }
+}
+
+// Mediana de tempo constante (Perreault & Hébert, 2007): um histograma de 256 níveis por coluna
+// da janela, deslizado uma linha por vez, e um histograma do kernel deslizado uma coluna por vez.
+// Cada histograma tem 16 faixas grossas (16 níveis cada) sempre atualizadas; as faixas finas do
+// kernel só são atualizadas quando a busca da mediana desce nelas.
+namespace {
+
+struct ColumnHistogram {
+    uint16_t coarse[16];
+    uint16_t fine[256];
+};
+
+class MedianHistogram {
+public:
+    MedianHistogram(int kernelSize, int columns)
+        : k(kernelSize), rank(kernelSize * kernelSize / 2), cols(columns), columnHist(columns) {}
+
+    // Janela das linhas [top, top + k) do plano (canal c), colunas [0, cols)
+    void initColumns(const cv::Mat& padded, int top, int colOffset, int cn, int c) {
+        std::memset(columnHist.data(), 0, columnHist.size() * sizeof(ColumnHistogram));
+        for (int r = top; r < top + k; r++) addRow(padded.ptr<uchar>(r), colOffset, cn, c, 1);
+    }
+
+    void slideDown(const cv::Mat& padded, int removedRow, int addedRow, int colOffset, int cn, int c) {
+        addRow(padded.ptr<uchar>(removedRow), colOffset, cn, c, -1);
+        addRow(padded.ptr<uchar>(addedRow), colOffset, cn, c, 1);
+    }
+
+    // Medianas das posições [0, cols - k + 1) da linha atual
+    void medianRow(uchar* dst, int cn) {
+        std::memset(coarse, 0, sizeof(coarse));
+        for (int x = 0; x < k; x++)
+            for (int b = 0; b < 16; b++) coarse[b] += columnHist[x].coarse[b];
+        for (int s = 0; s < 16; s++) segmentPos[s] = -k;  // força recálculo
+        
+        int outputs = cols - k + 1;
+        for (int j = 0; j < outputs; j++) {
+            if (j > 0) {
+                const ColumnHistogram& out = columnHist[j - 1];
+                const ColumnHistogram& in = columnHist[j + k - 1];
+                for (int b = 0; b < 16; b++) coarse[b] += in.coarse[b] - out.coarse[b];
+            }
+            int count = 0, s = 0;
+            while (count + coarse[s] <= rank) count += coarse[s++];
+            updateSegment(s, j);
+            int v = s * 16;
+            while (count + fine[v] <= rank) count += fine[v++];
+            dst[j * cn] = static_cast<uchar>(v);
+        }
+    }
+
+private:
+    void addRow(const uchar* row, int colOffset, int cn, int c, int delta) {
+        const uchar* src = row + colOffset * cn + c;
+        for (int x = 0; x < cols; x++) {
+            uchar v = src[x * cn];
+            columnHist[x].coarse[v >> 4] += delta;
+            columnHist[x].fine[v] += delta;
+        }
+    }
+
+    // Leva a faixa fina s do kernel até as colunas [j, j + k)
+    void updateSegment(int s, int j) {
+        uint16_t* f = fine + s * 16;
+        int pos = segmentPos[s];
+        if (j - pos >= k) {
+            std::memset(f, 0, 16 * sizeof(uint16_t));
+            for (int x = j; x < j + k; x++) {
+                const uint16_t* col = columnHist[x].fine + s * 16;
+                for (int b = 0; b < 16; b++) f[b] += col[b];
+            }
+        } else {
+            for (int x = pos; x < j; x++) {
+                const uint16_t* out = columnHist[x].fine + s * 16;
+                const uint16_t* in = columnHist[x + k].fine + s * 16;
+                for (int b = 0; b < 16; b++) f[b] += in[b] - out[b];
+            }
+        }
+        segmentPos[s] = j;
+    }
+
+    int k, rank, cols;
+    std::vector<ColumnHistogram> columnHist;
+    uint16_t coarse[16];
+    uint16_t fine[256];
+    int segmentPos[16];
+};
+
+} // namespace
+
+// Mediana por rede de seleção para kernels pequenos (3x3 e 5x5): só min/max, sem desvios,
+// aplicada a blocos de elementos consecutivos da linha, 16 por registrador SSE2 (pminub/pmaxub).
+// As colunas verticais da janela são ordenadas uma única vez e
+// compartilhadas pelas K posições horizontais que as usam; depois as linhas da janela são
+// ordenadas e a mediana sai de uma rede sobre os elementos que ainda podem ser a mediana.
+namespace {
+
+// Pares da rede merge-exchange de Batcher (Knuth 5.2.2M) sobre os fios indicados
+std::vector<std::pair<int, int>> batcherPairs(const std::vector<int>& wires) {
+    std::vector<std::pair<int, int>> pairs;
+    int n = static_cast<int>(wires.size());
+    if (n <= 1) return pairs;
+    int t = 0;
+    while ((1 << t) < n) t++;
+    for (int p = 1 << (t - 1); p > 0; p >>= 1) {
+        int q = 1 << (t - 1), r = 0, d = p;
+        for (;;) {
+            for (int i = 0; i < n - d; i++) {
+                if ((i & p) == r) pairs.push_back({wires[i], wires[i + d]});
+            }
+            if (q == p) break;
+            d = q - p;
+            q >>= 1;
+            r = p;
+        }
+    }
+    return pairs;
+}
+
+struct SelectionNetwork {
+    struct Comparator {
+        int a, b;          // após a troca: a = min, b = max
+        bool needMin, needMax;
+    };
+    std::vector<std::pair<int, int>> columnSort;   // ordenação das K linhas de cada coluna
+    std::vector<Comparator> ops;                    // fio r * K + c = r-ésimo menor da coluna c
+    std::vector<int> inputs;                        // fios lidos pela rede
+    int target = 0;
+};
+
+// Com colunas e linhas ordenadas, o elemento (r, c) tem ao menos (r+1)(c+1)-1 menores e
+// (K-r)(K-c)-1 maiores; só os que não ficam garantidamente abaixo ou acima da mediana entram
+// na rede final. Comparadores cujo resultado já é conhecido (colunas ordenadas) são removidos,
+// e em seguida os que não influenciam a saída.
+SelectionNetwork buildSelectionNetwork(int k) {
+    SelectionNetwork net;
+    int n = k * k, rank = n / 2;
+
+    std::vector<int> column(k);
+    for (int r = 0; r < k; r++) column[r] = r;
+    net.columnSort = batcherPairs(column);
+
+    std::vector<std::pair<int, int>> pairs;
+    for (int r = 0; r < k; r++) {
+        std::vector<int> row(k);
+        for (int c = 0; c < k; c++) row[c] = r * k + c;
+        auto rowPairs = batcherPairs(row);
+        pairs.insert(pairs.end(), rowPairs.begin(), rowPairs.end());
+    }
+    std::vector<int> candidates;
+    int below = 0;
+    for (int r = 0; r < k; r++) {
+        for (int c = 0; c < k; c++) {
+            if ((k - r) * (k - c) > n - rank) below++;
+            else if ((r + 1) * (c + 1) <= rank + 1) candidates.push_back(r * k + c);
+        }
+    }
+    auto candidatePairs = batcherPairs(candidates);
+    pairs.insert(pairs.end(), candidatePairs.begin(), candidatePairs.end());
+    net.target = candidates[rank - below];
+
+    // le[x * n + y]: o valor do fio x é garantidamente <= o do fio y
+    std::vector<char> le(n * n, 0);
+    for (int c = 0; c < k; c++)
+        for (int r1 = 0; r1 < k; r1++)
+            for (int r2 = r1; r2 < k; r2++) le[(r1 * k + c) * n + r2 * k + c] = 1;
+    std::vector<std::pair<int, int>> kept;
+    for (const auto& p : pairs) {
+        int a = p.first, b = p.second;
+        if (le[a * n + b]) continue;
+        kept.push_back(p);
+        for (int x = 0; x < n; x++) {
+            if (x == a || x == b) continue;
+            char aLeX = le[a * n + x], bLeX = le[b * n + x];
+            char xLeA = le[x * n + a], xLeB = le[x * n + b];
+            le[a * n + x] = aLeX || bLeX;
+            le[x * n + a] = xLeA && xLeB;
+            le[b * n + x] = aLeX && bLeX;
+            le[x * n + b] = xLeA || xLeB;
+        }
+        le[a * n + b] = 1;
+        le[b * n + a] = 0;
+    }
+
+    std::vector<bool> needed(n, false);
+    needed[net.target] = true;
+    for (auto it = kept.rbegin(); it != kept.rend(); ++it) {
+        bool needMin = needed[it->first], needMax = needed[it->second];
+        if (!needMin && !needMax) continue;
+        net.ops.push_back({it->first, it->second, needMin, needMax});
+        needed[it->first] = needed[it->second] = true;
+    }
+    std::reverse(net.ops.begin(), net.ops.end());
+    for (int w = 0; w < n; w++) {
+        if (needed[w]) net.inputs.push_back(w);
+    }
+    return net;
+}
+
+const SelectionNetwork& selectionNetwork(int k) {
+    static const SelectionNetwork net3 = buildSelectionNetwork(3);
+    static const SelectionNetwork net5 = buildSelectionNetwork(5);
+    return k == 3 ? net3 : net5;
+}
+
+// a = min(a, b) e/ou b = max(a, b) sobre len bytes (múltiplo de 16)
+template <bool StoreMin, bool StoreMax>
+inline void compareExchange(uchar* a, uchar* b, int len) {
+#if defined(PAVIC_MEDIAN_SSE2)
+    for (int l = 0; l < len; l += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + l));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + l));
+        if (StoreMin) _mm_storeu_si128(reinterpret_cast<__m128i*>(a + l), _mm_min_epu8(x, y));
+        if (StoreMax) _mm_storeu_si128(reinterpret_cast<__m128i*>(b + l), _mm_max_epu8(x, y));
+    }
+#else
+    for (int l = 0; l < len; l++) {
+        uchar x = a[l], y = b[l];
+        if (StoreMin) a[l] = std::min(x, y);
+        if (StoreMax) b[l] = std::max(x, y);
+    }
+#endif
+}
+
+void medianNetworkRows(const cv::Mat& padded, cv::Mat& output, int k, int rowStart, int rowEnd) {
+    const SelectionNetwork& net = selectionNetwork(k);
+    const int block = 64;
+    int cn = output.channels();
+    int rowLen = output.cols * cn;
+    int span = (block + (k - 1) * cn + 15) & ~15;
+    std::vector<uchar> columns(k * span);   // K linhas da janela, ordenadas por coluna
+    std::vector<uchar> wires(k * k * block);
+
+    for (int i = rowStart; i < rowEnd; i++) {
+        uchar* dst = output.ptr<uchar>(i);
+        for (int j = 0; j < rowLen; j += block) {
+            int len = std::min(block, rowLen - j);
+            int spanLen = len + (k - 1) * cn;
+            for (int r = 0; r < k; r++)
+                std::memcpy(columns.data() + r * span, padded.ptr<uchar>(i + r) + j, spanLen);
+            // Os blocos são processados inteiros; bytes além de len não chegam à saída
+            for (const auto& p : net.columnSort)
+                compareExchange<true, true>(columns.data() + p.first * span, columns.data() + p.second * span, span);
+
+            for (int w : net.inputs)
+                std::memcpy(wires.data() + w * block, columns.data() + (w / k) * span + (w % k) * cn, len);
+            for (const auto& op : net.ops) {
+                uchar* a = wires.data() + op.a * block;
+                uchar* b = wires.data() + op.b * block;
+                if (op.needMin && op.needMax) compareExchange<true, true>(a, b, block);
+                else if (op.needMin) compareExchange<true, false>(a, b, block);
+                else compareExchange<false, true>(a, b, block);
+            }
+            std::memcpy(dst + j, wires.data() + net.target * block, len);
+        }
+    }
+}
+
+} // namespace
+
+// Mesma mediana de ordenar a janela K x K (elemento K*K/2), com custo por pixel independente de K.
+// As colunas são processadas em faixas para que os histogramas caibam na cache.
+// Kernels 3x3 e 5x5 usam a rede de seleção acima, mais rápida nesses tamanhos.
+void medianRows(const cv::Mat& padded, cv::Mat& output, int kernelSize, int rowStart, int rowEnd) {
+    if (rowStart >= rowEnd) return;
+    if (kernelSize == 3 || kernelSize == 5) {
+        medianNetworkRows(padded, output, kernelSize, rowStart, rowEnd);
+        return;
+    }
+    int cn = output.channels();
+    const int strip = 256;
+    for (int x0 = 0; x0 < output.cols; x0 += strip) {
+        int width = std::min(strip, output.cols - x0);
+        MedianHistogram hist(kernelSize, width + kernelSize - 1);
+        for (int c = 0; c < cn; c++) {
+            hist.initColumns(padded, rowStart, x0, cn, c);
+            for (int i = rowStart; i < rowEnd; i++) {
+                if (i > rowStart) hist.slideDown(padded, i - 1, i + kernelSize - 1, x0, cn, c);
+                hist.medianRow(output.ptr<uchar>(i) + x0 * cn + c, cn);
+            }
+        }
+    }
+}
+
+// Sobel 3x3 de uma linha a partir das linhas de cima, do meio e de baixo, com a borda horizontal
+// replicada só nas colunas extremas; store(j, gx, gy) recebe os gradientes em int16
+template <typename Store>
+static inline void sobelRow(const uchar* r0, const uchar* r1, const uchar* r2, int cols, Store store) {
+    auto at = [&](int j, int l, int r) {
+        int16_t gx = static_cast<int16_t>((r0[r] + 2 * r1[r] + r2[r]) - (r0[l] + 2 * r1[l] + r2[l]));
+        int16_t gy = static_cast<int16_t>((r2[l] + 2 * r2[j] + r2[r]) - (r0[l] + 2 * r0[j] + r0[r]));
+        store(j, gx, gy);
+    };
+    if (cols == 1) {
+        at(0, 0, 0);
+        return;
+    }
+    at(0, 0, 1);
+    for (int j = 1; j < cols - 1; j++) at(j, j - 1, j + 1);
+    at(cols - 1, cols - 2, cols - 1);
+}
+
+template <GradientNorm Norm>
+static void sobelMagnitudeRow(const uchar* r0, const uchar* r1, const uchar* r2, uchar* dst, int cols) {
+    sobelRow(r0, r1, r2, cols, [dst](int j, int gx, int gy) {
+        dst[j] = cv::saturate_cast<uchar>(gradientMagnitude(gx, gy, Norm));
+    });
+}
+
+void sobelRows(const cv::Mat& gray, cv::Mat& output, GradientNorm norm, int rowStart, int rowEnd) {
+    int rows = gray.rows;
+    for (int i = rowStart; i < rowEnd; i++) {
+        const uchar* r0 = gray.ptr<uchar>(std::max(i - 1, 0));
+        const uchar* r1 = gray.ptr<uchar>(i);
+        const uchar* r2 = gray.ptr<uchar>(std::min(i + 1, rows - 1));
+        uchar* dst = output.ptr<uchar>(i);
+        switch (norm) {
+            case GradientNorm::L1: sobelMagnitudeRow<GradientNorm::L1>(r0, r1, r2, dst, gray.cols); break;
+            case GradientNorm::FAST: sobelMagnitudeRow<GradientNorm::FAST>(r0, r1, r2, dst, gray.cols); break;
+            default: sobelMagnitudeRow<GradientNorm::L2>(r0, r1, r2, dst, gray.cols); break;
+        }
+    }
+}
+
+// Linha do gradiente do Canny (magnitude L2 + setor)
+static void cannyGradientRow(const uchar* r0, const uchar* r1, const uchar* r2, uint16_t* dst, int cols) {
+    sobelRow(r0, r1, r2, cols, [dst](int j, int gx, int gy) {
+        dst[j] = packCannyGradient(gradientMagnitude(gx, gy, GradientNorm::L2), gx, gy);
+    });
+}
+
+// NMS de uma linha interior; a primeira e a última coluna ficam em 0
+static void cannyNmsRow(const uint16_t* up, const uint16_t* mid, const uint16_t* down, uchar* dst, int cols,
+                        double threshold1, double threshold2) {
+    std::memset(dst, 0, cols);
+    for (int j = 1; j < cols - 1; j++) {
+        int m = mid[j] >> 2, q, r;
+        // Vizinhos ao longo do gradiente (y cresce para baixo)
+        switch (mid[j] & 3) {
+            case 0: q = mid[j + 1]; r = mid[j - 1]; break;
+            case 1: q = down[j + 1]; r = up[j - 1]; break;
+            case 2: q = down[j]; r = up[j]; break;
+            default: q = down[j - 1]; r = up[j + 1]; break;
+        }
+        if (m >= (q >> 2) && m >= (r >> 2)) {
+            if (m >= threshold2) dst[j] = 255;
+            else if (m >= threshold1) dst[j] = 128;
+        }
+    }
+}
+
+void cannyGradientRows(const cv::Mat& gray, cv::Mat& gradient, int rowStart, int rowEnd) {
+    int rows = gray.rows;
+    for (int i = rowStart; i < rowEnd; i++) {
+        cannyGradientRow(gray.ptr<uchar>(std::max(i - 1, 0)), gray.ptr<uchar>(i), gray.ptr<uchar>(std::min(i + 1, rows - 1)),
+                         gradient.ptr<uint16_t>(i), gray.cols);
+    }
+}
+
+void cannyNmsRows(const cv::Mat& gradient, cv::Mat& edges, double threshold1, double threshold2,
+                  int rowStart, int rowEnd) {
+    int rows = gradient.rows;
+    for (int i = rowStart; i < rowEnd; i++) {
+        uchar* dst = edges.ptr<uchar>(i);
+        if (i == 0 || i == rows - 1) {
+            std::memset(dst, 0, edges.cols);
+            continue;
+        }
+        cannyNmsRow(gradient.ptr<uint16_t>(i - 1), gradient.ptr<uint16_t>(i), gradient.ptr<uint16_t>(i + 1),
+                    dst, gradient.cols, threshold1, threshold2);
+    }
+}
+
+// Canny em fluxo: cada estágio guarda só as linhas de que o seguinte precisa, em anéis indexados
+// pela linha absoluta (linha y na posição y % tamanho). Os estágios são puxados sob demanda:
+// a NMS da linha i pede o gradiente até i + 1, que pede o borrado até i + 2, que pede o passe
+// horizontal até i + 4. A aritmética é a mesma de grayscale + gaussianBlur(5) + cannyGradientRows
+// + cannyNmsRows em precisão DOUBLE, então o resultado é idêntico ao do pipeline materializado.
+void cannyFusedRows(const cv::Mat& input, cv::Mat& edges, double threshold1, double threshold2,
+                    int rowStart, int rowEnd) {
+    if (rowStart >= rowEnd) return;
+    const int k = 5, r = k / 2;
+    const std::vector<double> kernel = getGaussianKernel1D(k);
+    int rows = input.rows, cols = input.cols;
+
+    cv::Mat grayPadded(1, cols + 2 * r, CV_8UC1);       // linha cinza com borda horizontal replicada
+    cv::Mat horizontal(k, cols, CV_64FC1);              // passe horizontal da Gaussiana
+    cv::Mat blurred(3, cols, CV_8UC1);
+    cv::Mat gradient(3, cols, CV_16UC1);
+
+    int gradientStart = std::max(rowStart - 1, 0);
+    int blurredStart = std::max(gradientStart - 1, 0);
+    int lastH = std::max(blurredStart - r, 0) - 1, lastB = blurredStart - 1, lastG = gradientStart - 1;
+
+    auto computeH = [&](int y) {
+        uchar* g = grayPadded.ptr<uchar>(0);
+        cv::Mat grayRow(1, cols, CV_8UC1, g + r);
+        if (input.channels() == 3) grayscaleRows(input.row(y), grayRow, 0, 1, Precision::DOUBLE);
+        else std::memcpy(g + r, input.ptr<uchar>(y), cols);
+        for (int q = 0; q < r; q++) {
+            g[q] = g[r];
+            g[r + cols + q] = g[r + cols - 1];
+        }
+        cv::Mat dst = horizontal.row(y % k);
+        rowPass<double>(grayPadded, dst, kernel, 0, 1);
+    };
+    auto computeB = [&](int y) {
+        const double* src[k];
+        for (int q = 0; q < k; q++) src[q] = horizontal.ptr<double>(std::min(std::max(y + q - r, 0), rows - 1) % k);
+        uchar* dst = blurred.ptr<uchar>(y % 3);
+        for (int j = 0; j < cols; j++) {
+            double acc = 0;
+            for (int q = 0; q < k; q++) acc += src[q][j] * kernel[q];
+            dst[j] = cv::saturate_cast<uchar>(acc);
+        }
+    };
+    auto ensureH = [&](int y) { while (lastH < y) computeH(++lastH); };
+    auto ensureB = [&](int y) {
+        while (lastB < y) {
+            ensureH(std::min(lastB + 1 + r, rows - 1));
+            computeB(++lastB);
+        }
+    };
+    auto ensureG = [&](int y) {
+        while (lastG < y) {
+            int g = ++lastG;
+            ensureB(std::min(g + 1, rows - 1));
+            cannyGradientRow(blurred.ptr<uchar>(std::max(g - 1, 0) % 3), blurred.ptr<uchar>(g % 3),
+                             blurred.ptr<uchar>(std::min(g + 1, rows - 1) % 3), gradient.ptr<uint16_t>(g % 3), cols);
+        }
+    };
+
+    for (int i = rowStart; i < rowEnd; i++) {
+        ensureG(std::min(i + 1, rows - 1));
+        uchar* dst = edges.ptr<uchar>(i);
+        if (i == 0 || i == rows - 1) {
+            std::memset(dst, 0, cols);
+            continue;
+        }
+        cannyNmsRow(gradient.ptr<uint16_t>((i - 1) % 3), gradient.ptr<uint16_t>(i % 3), gradient.ptr<uint16_t>((i + 1) % 3),
+                    dst, cols, threshold1, threshold2);
+    }
+}
+
+// Histerese por union-find. Cada pixel candidato aponta para o pai (índice >= 0) ou é raiz;
+// a raiz guarda se a componente tem alguma borda forte. União pelo menor índice, busca com
+// divisão do caminho pela metade.
+namespace {
+
+const int kBackground = -1, kWeakRoot = -2, kStrongRoot = -3;
+
+inline int findRoot(std::vector<int>& labels, int x) {
+    while (labels[x] >= 0) {
+        int parent = labels[x];
+        if (labels[parent] >= 0) labels[x] = labels[parent];
+        x = parent;
+    }
+    return x;
+}
+
+inline void unite(std::vector<int>& labels, int a, int b) {
+    int ra = findRoot(labels, a), rb = findRoot(labels, b);
+    if (ra == rb) return;
+    if (ra > rb) std::swap(ra, rb);
+    if (labels[rb] == kStrongRoot) labels[ra] = kStrongRoot;
+    labels[rb] = ra;
+}
+
+} // namespace
+
+void hysteresisLabelRows(const cv::Mat& edges, std::vector<int>& labels, int rowStart, int rowEnd) {
+    int cols = edges.cols;
+    for (int i = rowStart; i < rowEnd; i++) {
+        const uchar* row = edges.ptr<uchar>(i);
+        int base = i * cols;
+        for (int j = 0; j < cols; j++) {
+            int p = base + j;
+            if (row[j] != 255 && row[j] != 128) {
+                labels[p] = kBackground;
+                continue;
+            }
+            labels[p] = row[j] == 255 ? kStrongRoot : kWeakRoot;
+            // Vizinhos já visitados: esquerda e os três de cima. Se o de cima é candidato, a esquerda
+            // e as diagonais já estão na mesma componente dele; se o da esquerda é, a diagonal esquerda também.
+            bool hasUp = i > rowStart;
+            if (hasUp && labels[p - cols] != kBackground) {
+                unite(labels, p, p - cols);
+                continue;
+            }
+            if (j > 0 && labels[p - 1] != kBackground) unite(labels, p, p - 1);
+            else if (hasUp && j > 0 && labels[p - cols - 1] != kBackground) unite(labels, p, p - cols - 1);
+            if (hasUp && j + 1 < cols && labels[p - cols + 1] != kBackground) unite(labels, p, p - cols + 1);
+        }
+    }
+}
+
+void hysteresisMergeRow(std::vector<int>& labels, int cols, int row) {
+    if (row <= 0) return;
+    int base = row * cols, up = base - cols;
+    for (int j = 0; j < cols; j++) {
+        if (labels[base + j] == kBackground) continue;
+        for (int dj = std::max(j - 1, 0); dj <= std::min(j + 1, cols - 1); dj++)
+            if (labels[up + dj] != kBackground) unite(labels, base + j, up + dj);
+    }
+}
+
+void hysteresisResolveRows(cv::Mat& edges, const std::vector<int>& labels, int rowStart, int rowEnd) {
+    int cols = edges.cols;
+    for (int i = rowStart; i < rowEnd; i++) {
+        uchar* row = edges.ptr<uchar>(i);
+        for (int j = 0; j < cols; j++) {
+            int x = i * cols + j;
+            if (labels[x] == kBackground) {
+                row[j] = 0;
+                continue;
+            }
+            while (labels[x] >= 0) x = labels[x];   // só leitura: as faixas são resolvidas em paralelo
+            row[j] = labels[x] == kStrongRoot ? 255 : 0;
+        }
+    }
+}
+
+void hysteresis(cv::Mat& edges) {
+    std::vector<int> labels(edges.total());
+    hysteresisLabelRows(edges, labels, 0, edges.rows);
+    hysteresisResolveRows(edges, labels, 0, edges.rows);
+}
+
+static std::atomic<int> tileRows{0}, tileCols{0};
+
+void setTileSize(TileSize size) {
+    tileRows = std::max(0, size.rows);
+    tileCols = std::max(0, size.cols);
+}
+
+TileSize getTileSize() {
+    TileSize size;
+    size.rows = tileRows;
+    size.cols = tileCols;
+    return size;
+}
+
+static size_t detectCacheSize() {
+#ifdef _WIN32
+    DWORD len = 0;
+    GetLogicalProcessorInformation(nullptr, &len);
+    std::vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> info(len / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+    if (!info.empty() && GetLogicalProcessorInformation(info.data(), &len)) {
+        for (const auto& entry : info) {
+            if (entry.Relationship == RelationCache && entry.Cache.Level == 2) return entry.Cache.Size;
+        }
+    }
+#elif defined(_SC_LEVEL2_CACHE_SIZE)
+    long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (size > 0) return static_cast<size_t>(size);
+#endif
+    return 256 * 1024;
+}
+
+size_t getCacheSizeBytes() {
+    static const size_t size = detectCacheSize();
+    return size;
+}
+
+TileSize resolveTileSize(cv::Size imageSize, size_t bytesPerPixel, int haloY, int haloX) {
+    TileSize tile = getTileSize();
+    if (tile.cols <= 0) tile.cols = 256;
+    tile.cols = std::min(tile.cols, imageSize.width);
+    if (tile.rows <= 0) {
+        // Metade da L2 para a janela (tile + halo) e a saída; o resto fica para pesos e outra thread (SMT)
+        size_t rowBytes = static_cast<size_t>(tile.cols + 2 * haloX) * std::max<size_t>(bytesPerPixel, 1);
+        long rows = static_cast<long>(getCacheSizeBytes() / 2 / rowBytes) - 2 * haloY;
+        tile.rows = static_cast<int>(std::max(rows, 16L));
+    }
+    tile.rows = std::max(1, std::min(tile.rows, imageSize.height));
+    tile.cols = std::max(1, tile.cols);
+    return tile;
+}
+
+// Divide a região em tiles de no máximo tile.rows x tile.cols
+static void appendTiles(std::vector<cv::Rect>& tiles, const cv::Rect& region, TileSize tile) {
+    for (int y = region.y; y < region.y + region.height; y += tile.rows) {
+        for (int x = region.x; x < region.x + region.width; x += tile.cols) {
+            tiles.emplace_back(x, y, std::min(tile.cols, region.x + region.width - x),
+                               std::min(tile.rows, region.y + region.height - y));
+        }
+    }
+}
+
+std::vector<cv::Rect> makeTiles(cv::Size imageSize, TileSize tile, int haloY, int haloX) {
+    int w = imageSize.width, h = imageSize.height;
+    // Interior [y0, y1) x [x0, x1); se a imagem for menor que o kernel tudo é borda
+    int y0 = std::min(haloY, h), y1 = std::max(y0, h - haloY);
+    int x0 = std::min(haloX, w), x1 = std::max(x0, w - haloX);
+    if (x0 == x1) y1 = y0;
+    
+    std::vector<cv::Rect> tiles;
+    appendTiles(tiles, cv::Rect(x0, y0, x1 - x0, y1 - y0), tile);
+    appendTiles(tiles, cv::Rect(0, 0, w, y0), tile);
+    appendTiles(tiles, cv::Rect(0, y1, w, h - y1), tile);
+    appendTiles(tiles, cv::Rect(0, y0, x0, y1 - y0), tile);
+    appendTiles(tiles, cv::Rect(x1, y0, w - x1, y1 - y0), tile);
+    return tiles;
+}
+
+cv::Mat sourceWindow(const cv::Mat& input, const cv::Rect& tile, int haloY, int haloX) {
+    cv::Rect window(tile.x - haloX, tile.y - haloY, tile.width + 2 * haloX, tile.height + 2 * haloY);
+    cv::Rect inside = window & cv::Rect(0, 0, input.cols, input.rows);
+    if (inside == window) return input(window);
+    
+    cv::Mat local;
+    cv::copyMakeBorder(input(inside), local, inside.y - window.y, window.y + window.height - inside.y - inside.height,
+                       inside.x - window.x, window.x + window.width - inside.x - inside.width, cv::BORDER_REPLICATE);
+    return local;
+}
+
+cv::Mat detachedInput(const cv::Mat& input, const cv::Mat& output) {
+    return input.data == output.data ? input.clone() : input;
+}
+
+// Prefixo horizontal de uma linha (com zero inicial); T sem sinal para CV_32S, double para CV_64F.
+// Quadrados sempre em double: 255^2 por pixel estoura 32 bits rapidamente.
+template <typename T>
+static void integralRow(const uchar* src, T* sum, double* sqsum, int cols, int cn) {
+    for (int c = 0; c < cn; c++) {
+        T s = 0;
+        double sq = 0;
+        sum[c] = 0;
+        if (sqsum) sqsum[c] = 0;
+        for (int j = 0; j < cols; j++) {
+            uchar v = src[j * cn + c];
+            s += v;
+            sum[(j + 1) * cn + c] = s;
+            if (sqsum) {
+                sq += static_cast<double>(v) * v;
+                sqsum[(j + 1) * cn + c] = sq;
+            }
+        }
+    }
+}
+
+// Prefixo vertical nas colunas de elementos [colStart, colEnd): linhas inteiras, acesso contíguo
+template <typename T>
+static void integralColumns(cv::Mat& sum, int colStart, int colEnd) {
+    for (int i = 2; i < sum.rows; i++) {
+        const T* prev = reinterpret_cast<const T*>(sum.ptr<uchar>(i - 1));
+        T* row = reinterpret_cast<T*>(sum.ptr<uchar>(i));
+        for (int j = colStart; j < colEnd; j++) row[j] += prev[j];
+    }
+}
+
+template <typename T>
+static void buildIntegral(const cv::Mat& input, cv::Mat& sum, cv::Mat* sqsum) {
+    int cn = input.channels(), rowLen = (input.cols + 1) * cn;
+    std::fill(sum.ptr<uchar>(0), sum.ptr<uchar>(0) + rowLen * sum.elemSize1(), 0);
+    if (sqsum) std::fill(sqsum->ptr<double>(0), sqsum->ptr<double>(0) + rowLen, 0.0);
+    
+    #pragma omp parallel for
+    for (int i = 0; i < input.rows; i++) {
+        integralRow<T>(input.ptr<uchar>(i), reinterpret_cast<T*>(sum.ptr<uchar>(i + 1)),
+                       sqsum ? sqsum->ptr<double>(i + 1) : nullptr, input.cols, cn);
+    }
+    
+    // Faixas de 256 elementos: cada thread desce todas as linhas da sua faixa
+    const int band = 256;
+    #pragma omp parallel for
+    for (int start = 0; start < rowLen; start += band) {
+        int end = std::min(start + band, rowLen);
+        integralColumns<T>(sum, start, end);
+        if (sqsum) integralColumns<double>(*sqsum, start, end);
+    }
+}
+
+static void integralImpl(const cv::Mat& input, cv::Mat& sum, cv::Mat* sqsum, int sdepth) {
+    CV_Assert(input.depth() == CV_8U && (sdepth == CV_32S || sdepth == CV_64F));
+    int cn = input.channels();
+    sum.create(input.rows + 1, input.cols + 1, CV_MAKETYPE(sdepth, cn));
+    if (sqsum) sqsum->create(input.rows + 1, input.cols + 1, CV_MAKETYPE(CV_64F, cn));
+    if (sdepth == CV_32S) buildIntegral<uint32_t>(input, sum, sqsum);
+    else buildIntegral<double>(input, sum, sqsum);
+}
+
+void integral(const cv::Mat& input, cv::Mat& sum, int sdepth) {
+    integralImpl(input, sum, nullptr, sdepth);
+}
+
+void integral(const cv::Mat& input, cv::Mat& sum, cv::Mat& sqsum, int sdepth) {
+    integralImpl(input, sum, &sqsum, sdepth);
+}
+
+cv::Mat variableBoxBlur(const cv::Mat& input, const cv::Mat& radius) {
+    if (input.empty()) return cv::Mat();
+    CV_Assert(radius.type() == CV_8UC1 && radius.size() == input.size());
+    
+    // Até 255 x (2*255+1)^2 < 2^31 por janela: 32 bits bastam
+    cv::Mat sum;
+    integral(input, sum, CV_32S);
+    int cn = input.channels();
+    cv::Mat output(input.size(), input.type());
+    
+    #pragma omp parallel for
+    for (int i = 0; i < input.rows; i++) {
+        const uchar* r = radius.ptr<uchar>(i);
+        uchar* dst = output.ptr<uchar>(i);
+        for (int j = 0; j < input.cols; j++) {
+            int y0 = std::max(0, i - r[j]), y1 = std::min(input.rows, i + r[j] + 1);
+            int x0 = std::max(0, j - r[j]), x1 = std::min(input.cols, j + r[j] + 1);
+            double area = static_cast<double>(y1 - y0) * (x1 - x0);
+            for (int c = 0; c < cn; c++) {
+                dst[j * cn + c] = cv::saturate_cast<uchar>(windowSum<int>(sum, y0, x0, y1, x1, c) / area);
+            }
+        }
+    }
+    return output;
+}
+
+void localMeanVariance(const cv::Mat& input, int kernelSize, cv::Mat& mean, cv::Mat& variance) {
+    cv::Mat sum, sqsum;
+    integral(input, sum, sqsum, CV_64F);
+    int cn = input.channels(), r = kernelSize / 2;
+    mean.create(input.size(), CV_MAKETYPE(CV_32F, cn));
+    variance.create(input.size(), CV_MAKETYPE(CV_32F, cn));
+    
+    #pragma omp parallel for
+    for (int i = 0; i < input.rows; i++) {
+        float* m = mean.ptr<float>(i);
+        float* v = variance.ptr<float>(i);
+        int y0 = std::max(0, i - r), y1 = std::min(input.rows, i + r + 1);
+        for (int j = 0; j < input.cols; j++) {
+            int x0 = std::max(0, j - r), x1 = std::min(input.cols, j + r + 1);
+            double area = static_cast<double>(y1 - y0) * (x1 - x0);
+            for (int c = 0; c < cn; c++) {
+                double mu = windowSum<double>(sum, y0, x0, y1, x1, c) / area;
+                double sq = windowSum<double>(sqsum, y0, x0, y1, x1, c) / area;
+                m[j * cn + c] = static_cast<float>(mu);
+                v[j * cn + c] = static_cast<float>(std::max(0.0, sq - mu * mu));
+            }
+        }
+    }
+}
+
+PlanarImage toPlanar(const cv::Mat& input) {
+    PlanarImage planar;
+    int cn = input.channels();
+    if (cn == 1) {
+        planar.planes.push_back(input);
+        return planar;
+    }
+    for (int c = 0; c < cn; c++) planar.planes.emplace_back(input.rows, input.cols, CV_8UC1);
+    
+    #pragma omp parallel for
+    for (int i = 0; i < input.rows; i++) {
+        const uchar* src = input.ptr<uchar>(i);
+        if (cn == 3) {
+            uchar* p0 = planar.planes[0].ptr<uchar>(i);
+            uchar* p1 = planar.planes[1].ptr<uchar>(i);
+            uchar* p2 = planar.planes[2].ptr<uchar>(i);
+            for (int j = 0; j < input.cols; j++, src += 3) {
+                p0[j] = src[0];
+                p1[j] = src[1];
+                p2[j] = src[2];
+            }
+        } else {
+            for (int c = 0; c < cn; c++) {
+                uchar* dst = planar.planes[c].ptr<uchar>(i);
+                for (int j = 0; j < input.cols; j++) dst[j] = src[j * cn + c];
+            }
+        }
+    }
+    return planar;
+}
+
+cv::Mat fromPlanar(const PlanarImage& planar) {
+    if (planar.empty()) return cv::Mat();
+    int cn = planar.channels();
+    if (cn == 1) return planar.planes[0];
+    
+    cv::Size size = planar.size();
+    cv::Mat output(size.height, size.width, CV_MAKETYPE(CV_8U, cn));
+    
+    #pragma omp parallel for
+    for (int i = 0; i < size.height; i++) {
+        uchar* dst = output.ptr<uchar>(i);
+        if (cn == 3) {
+            const uchar* p0 = planar.planes[0].ptr<uchar>(i);
+            const uchar* p1 = planar.planes[1].ptr<uchar>(i);
+            const uchar* p2 = planar.planes[2].ptr<uchar>(i);
+            for (int j = 0; j < size.width; j++, dst += 3) {
+                dst[0] = p0[j];
+                dst[1] = p1[j];
+                dst[2] = p2[j];
+            }
+        } else {
+            for (int c = 0; c < cn; c++) {
+                const uchar* src = planar.planes[c].ptr<uchar>(i);
+                for (int j = 0; j < size.width; j++) dst[j * cn + c] = src[j];
+            }
+        }
+    }
+    return output;
+}
+
 cv::Mat padImage(const cv::Mat& input, int padding, int borderType) {
     cv::Mat padded;
     cv::copyMakeBorder(input, padded, padding, padding, padding, padding, borderType);
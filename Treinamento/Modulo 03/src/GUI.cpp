@@ -6,6 +6,7 @@
 #include "GUI.h"
 #include "WebcamCapture.h"
 #include "PerformanceMetrics.h"
+#include "BufferPool.h"
 
 #include <opencv2/opencv.hpp>
 #include <iostream>
@@ -21,7 +22,9 @@ GUI::GUI(const std::string& windowName, int width, int height)
 GUI::~GUI() {}
 
 void GUI::init() {
+    BufferPool::global().install();
     canvas = cv::Mat(windowHeight, windowWidth, CV_8UC3, colBG);
+    processor.setResultCacheBudget(512u << 20);
     cv::namedWindow(windowName, cv::WINDOW_NORMAL);
     cv::resizeWindow(windowName, windowWidth, windowHeight);
     cv::setMouseCallback(windowName, GUI::mouseCallback, this);
@@ -143,7 +146,7 @@ void GUI::createFilterButtons() {
 
 void GUI::createProcessingButtons() {
     processingButtons.clear();
-    int x = 20, y = 55, w = 150, h = 40, gap = 10;
+    int x = 20, y = 55, w = 140, h = 40, gap = 10;
     auto add = [&](const std::string& label, ProcessingType pt){
         processingButtons.push_back(createButton(x, y, w, h, label, [this, pt]{ currentProcessing = pt; applyCurrentFilter(); drawInterface(); }));
         x += w + gap;
@@ -152,6 +155,8 @@ void GUI::createProcessingButtons() {
     add("Parallel", ProcessingType::PARALLEL);
     add("Multithread", ProcessingType::MULTITHREAD);
     add("CUDA", ProcessingType::CUDA);
+    add("SIMD", ProcessingType::SIMD);
+    add("SIMD+Threads", ProcessingType::SIMD_MULTITHREAD);
 }
 
 void GUI::createControlButtons() {
@@ -180,6 +185,7 @@ void GUI::saveImageAction() {
 void GUI::toggleWebcam() {
     if (!useWebcam) {
         useWebcam = true;
+        incremental.reset();
         if (!webcam.start()) { useWebcam = false; std::cout << "Webcam não abriu.\n"; return; }
     } else {
         useWebcam = false; webcam.stop();
@@ -187,15 +193,18 @@ void GUI::toggleWebcam() {
 }
 
 void GUI::applyCurrentFilter() {
+    bool fromWebcam = useWebcam && webcam.isRunning();
     cv::Mat src;
-    if (useWebcam && webcam.isRunning()) {
+    if (fromWebcam) {
         src = webcam.getFrame();
-    } else {
-        src = processor.getOriginalImage();
-        if (src.empty()) return;
+    } else if (processor.getOriginalImage().empty()) {
+        return;
     }
     auto start = std::chrono::high_resolution_clock::now();
-    ProcessingResult r = processor.processFrame(src, currentFilter, currentProcessing);
+    // Imagem estática: applyFilter reaproveita o hash da imagem carregada, então voltar a um
+    // filtro/modo já visto sai da cache sem reler a imagem
+    ProcessingResult r = fromWebcam ? incremental.processFrame(src, currentFilter, currentProcessing)
+                                    : processor.applyFilter(currentFilter, currentProcessing);
     auto end = std::chrono::high_resolution_clock::now();
     lastExecutionTime = std::chrono::duration<double, std::milli>(end - start).count();
     if (r.success) {
@@ -8,10 +8,13 @@
 #include "ParallelFilter.h"
 #include "MultithreadFilter.h"
 #include "CUDAFilter.h"
+#include "SimdFilter.h"
 #include "FilterUtils.h"
 
 #include <opencv2/opencv.hpp>
 #include <stdexcept>
+#include <cstring>
+#include <cmath>
 
 namespace pavic {
 
@@ -21,6 +24,7 @@ ImageProcessor::~ImageProcessor() {}
 bool ImageProcessor::loadImage(const std::string& filepath) {
     originalImage = cv::imread(filepath, cv::IMREAD_COLOR);
     processedImage.release();
+    originalHashValid = false;
     return !originalImage.empty();
 }
 
@@ -28,6 +32,7 @@ bool ImageProcessor::loadImage(const cv::Mat& image) {
     if (image.empty()) return false;
     originalImage = image.clone();
     processedImage.release();
+    originalHashValid = false;
     return true;
 }
 
@@ -39,79 +44,102 @@ bool ImageProcessor::saveImage(const std::string& filepath, const cv::Mat& image
 cv::Mat ImageProcessor::getOriginalImage() const { return originalImage; }
 cv::Mat ImageProcessor::getProcessedImage() const { return processedImage; }
 
-static cv::Mat applyFilterImpl(const cv::Mat& input, FilterType filter, ProcessingType processing) {
+// Escreve em output, reaproveitando o buffer quando tamanho e tipo batem
+static void applyFilterImpl(const cv::Mat& input, cv::Mat& output, const FilterStep& step, ProcessingType processing,
+                            Precision precision) {
     using namespace pavic;
+    const int k = step.kernelSize;
     switch (processing) {
         case ProcessingType::SEQUENTIAL: {
             using namespace sequential;
-            switch (filter) {
-                case FilterType::GRAYSCALE: return grayscale(input);
-                case FilterType::BLUR: return blur(input, 5);
-                case FilterType::GAUSSIAN_BLUR: return gaussianBlur(input, 5);
-                case FilterType::SOBEL: return sobel(input);
-                case FilterType::CANNY: return canny(input, 50, 150);
-                case FilterType::SHARPEN: return sharpen(input);
-                case FilterType::EMBOSS: return emboss(input);
-                case FilterType::NEGATIVE: return negative(input);
-                case FilterType::SEPIA: return sepia(input);
-                case FilterType::THRESHOLD: return threshold(input, 128);
-                case FilterType::MEDIAN: return median(input, 5);
-                case FilterType::BILATERAL: return bilateral(input, 9, 75, 75);
+            switch (step.filter) {
+                case FilterType::GRAYSCALE: grayscale(input, output, precision); return;
+                case FilterType::BLUR: boxBlur(input, output, k); return;
+                case FilterType::GAUSSIAN_BLUR: gaussianBlur(input, output, k, precision); return;
+                case FilterType::SOBEL: sobel(input, output, step.norm); return;
+                case FilterType::CANNY: canny(input, output, step.threshold1, step.threshold2); return;
+                case FilterType::SHARPEN: sharpen(input, output); return;
+                case FilterType::EMBOSS: emboss(input, output); return;
+                case FilterType::NEGATIVE: negative(input, output); return;
+                case FilterType::SEPIA: sepia(input, output, precision); return;
+                case FilterType::THRESHOLD: threshold(input, output, step.thresholdValue); return;
+                case FilterType::MEDIAN: median(input, output, k); return;
+                case FilterType::BILATERAL: bilateral(input, output, step.d, step.sigmaColor, step.sigmaSpace, precision); return;
             }
             break;
         }
         case ProcessingType::PARALLEL: {
             using namespace parallel;
-            switch (filter) {
-                case FilterType::GRAYSCALE: return grayscale(input);
-                case FilterType::BLUR: return blur(input, 5);
-                case FilterType::GAUSSIAN_BLUR: return gaussianBlur(input, 5);
-                case FilterType::SOBEL: return sobel(input);
-                case FilterType::CANNY: return canny(input, 50, 150);
-                case FilterType::SHARPEN: return sharpen(input);
-                case FilterType::EMBOSS: return emboss(input);
-                case FilterType::NEGATIVE: return negative(input);
-                case FilterType::SEPIA: return sepia(input);
-                case FilterType::THRESHOLD: return threshold(input, 128);
-                case FilterType::MEDIAN: return median(input, 5);
-                case FilterType::BILATERAL: return bilateral(input, 9, 75, 75);
+            switch (step.filter) {
+                case FilterType::GRAYSCALE: grayscale(input, output, precision); return;
+                case FilterType::BLUR: boxBlur(input, output, k); return;
+                case FilterType::GAUSSIAN_BLUR: gaussianBlur(input, output, k, precision); return;
+                case FilterType::SOBEL: sobel(input, output, step.norm); return;
+                case FilterType::CANNY: canny(input, output, step.threshold1, step.threshold2); return;
+                case FilterType::SHARPEN: sharpen(input, output); return;
+                case FilterType::EMBOSS: emboss(input, output); return;
+                case FilterType::NEGATIVE: negative(input, output); return;
+                case FilterType::SEPIA: sepia(input, output, precision); return;
+                case FilterType::THRESHOLD: threshold(input, output, step.thresholdValue); return;
+                case FilterType::MEDIAN: median(input, output, k); return;
+                case FilterType::BILATERAL: bilateral(input, output, step.d, step.sigmaColor, step.sigmaSpace, precision); return;
             }
             break;
         }
         case ProcessingType::MULTITHREAD: {
             using namespace multithread;
-            switch (filter) {
-                case FilterType::GRAYSCALE: return grayscale(input);
-                case FilterType::BLUR: return blur(input, 5);
-                case FilterType::GAUSSIAN_BLUR: return gaussianBlur(input, 5);
-                case FilterType::SOBEL: return sobel(input);
-                case FilterType::CANNY: return canny(input, 50, 150);
-                case FilterType::SHARPEN: return sharpen(input);
-                case FilterType::EMBOSS: return emboss(input);
-                case FilterType::NEGATIVE: return negative(input);
-                case FilterType::SEPIA: return sepia(input);
-                case FilterType::THRESHOLD: return threshold(input, 128);
-                case FilterType::MEDIAN: return median(input, 5);
-                case FilterType::BILATERAL: return bilateral(input, 9, 75, 75);
+            switch (step.filter) {
+                case FilterType::GRAYSCALE: grayscale(input, output, 0, precision); return;
+                case FilterType::BLUR: boxBlur(input, output, k); return;
+                case FilterType::GAUSSIAN_BLUR: gaussianBlur(input, output, k, 0, precision); return;
+                case FilterType::SOBEL: sobel(input, output, 0, step.norm); return;
+                case FilterType::CANNY: canny(input, output, step.threshold1, step.threshold2); return;
+                case FilterType::SHARPEN: sharpen(input, output, 0); return;
+                case FilterType::EMBOSS: emboss(input, output, 0); return;
+                case FilterType::NEGATIVE: negative(input, output); return;
+                case FilterType::SEPIA: sepia(input, output, 0, precision); return;
+                case FilterType::THRESHOLD: threshold(input, output, step.thresholdValue); return;
+                case FilterType::MEDIAN: median(input, output, k); return;
+                case FilterType::BILATERAL: bilateral(input, output, step.d, step.sigmaColor, step.sigmaSpace, 0, precision); return;
             }
             break;
         }
         case ProcessingType::CUDA: {
             // Usa stubs que fazem fallback para CPU quando CUDA não está disponível
             using namespace cuda;
-            switch (filter) {
-                case FilterType::GRAYSCALE: return grayscale(input);
-                case FilterType::BLUR: return blur(input, 5);
-                case FilterType::GAUSSIAN_BLUR: return gaussianBlur(input, 5);
-                case FilterType::SOBEL: return sobel(input);
-                case FilterType::CANNY: return canny(input, 50, 150);
-                case FilterType::SHARPEN: return sharpen(input);
-                case FilterType::EMBOSS: return emboss(input);
-                case FilterType::NEGATIVE: return negative(input);
-                case FilterType::SEPIA: return sepia(input);
-                case FilterType::THRESHOLD: return threshold(input, 128);
-                case FilterType::MEDIAN: return median(input, 5);
-                case FilterType::BILATERAL: return bilateral(input, 9, 75, 75);
+            switch (step.filter) {
+                case FilterType::GRAYSCALE: grayscale(input, output); return;
+                case FilterType::BLUR: blur(input, output, k); return;
+                case FilterType::GAUSSIAN_BLUR: gaussianBlur(input, output, k); return;
+                case FilterType::SOBEL: sobel(input, output); return;
+                case FilterType::CANNY: canny(input, output, step.threshold1, step.threshold2); return;
+                case FilterType::SHARPEN: sharpen(input, output); return;
+                case FilterType::EMBOSS: emboss(input, output); return;
+                case FilterType::NEGATIVE: negative(input, output); return;
+                case FilterType::SEPIA: sepia(input, output); return;
+                case FilterType::THRESHOLD: threshold(input, output, step.thresholdValue); return;
+                case FilterType::MEDIAN: median(input, output, k); return;
+                case FilterType::BILATERAL: bilateral(input, output, step.d, step.sigmaColor, step.sigmaSpace); return;
+            }
+            break;
+        }
+        case ProcessingType::SIMD:
+        case ProcessingType::SIMD_MULTITHREAD: {
+            using namespace simd;
+            int threads = processing == ProcessingType::SIMD ? 1 : 0;
+            switch (step.filter) {
+                case FilterType::GRAYSCALE: grayscale(input, output, threads); return;
+                case FilterType::BLUR: blur(input, output, k, threads); return;
+                case FilterType::GAUSSIAN_BLUR: gaussianBlur(input, output, k, threads); return;
+                case FilterType::SOBEL: sobel(input, output, threads, step.norm); return;
+                case FilterType::CANNY: canny(input, output, step.threshold1, step.threshold2, threads); return;
+                case FilterType::SHARPEN: sharpen(input, output, threads); return;
+                case FilterType::EMBOSS: emboss(input, output, threads); return;
+                case FilterType::NEGATIVE: negative(input, output, threads); return;
+                case FilterType::SEPIA: sepia(input, output, threads); return;
+                case FilterType::THRESHOLD: threshold(input, output, step.thresholdValue, threads); return;
+                case FilterType::MEDIAN: median(input, output, k, threads); return;
+                case FilterType::BILATERAL: bilateral(input, output, step.d, step.sigmaColor, step.sigmaSpace, threads); return;
             }
             break;
         }
@@ -119,54 +147,559 @@ static cv::Mat applyFilterImpl(const cv::Mat& input, FilterType filter, Processi
     throw std::runtime_error("Filtro/Processamento inválido");
 }
 
-ProcessingResult ImageProcessor::applyFilter(FilterType filter, ProcessingType processing) {
+static cv::Mat applyFilterImpl(const cv::Mat& input, const FilterStep& step, ProcessingType processing, Precision precision) {
+    cv::Mat output;
+    applyFilterImpl(input, output, step, processing, precision);
+    return output;
+}
+
+bool ImageProcessor::isPerChannelFilter(FilterType filter) {
+    switch (filter) {
+        case FilterType::BLUR:
+        case FilterType::GAUSSIAN_BLUR:
+        case FilterType::SHARPEN:
+        case FilterType::EMBOSS:
+        case FilterType::NEGATIVE:
+        case FilterType::MEDIAN:
+        case FilterType::BILATERAL:
+            return true;
+        default:
+            return false;
+    }
+}
+
+utils::PlanarImage ImageProcessor::applyFilterPlanar(const utils::PlanarImage& input, const FilterStep& step,
+                                                     ProcessingType processing, Precision precision) {
+    if (!isPerChannelFilter(step.filter)) {
+        return utils::toPlanar(applyFilterImpl(utils::fromPlanar(input), step, processing, precision));
+    }
+    utils::PlanarImage output;
+    for (const cv::Mat& plane : input.planes) {
+        output.planes.push_back(applyFilterImpl(plane, step, processing, precision));
+    }
+    return output;
+}
+
+// Chave da cache: conteúdo da entrada + todos os parâmetros que podem mudar a saída
+static uint64_t resultCacheKey(uint64_t contentHash, const FilterStep& step, ProcessingType processing,
+                               Precision precision) {
+    uint64_t key = contentHash;
+    key = ResultCache::combine(key, static_cast<uint64_t>(step.filter));
+    key = ResultCache::combine(key, static_cast<uint64_t>(processing));
+    key = ResultCache::combine(key, static_cast<uint64_t>(precision));
+    key = ResultCache::combine(key, static_cast<uint64_t>(step.kernelSize));
+    key = ResultCache::combine(key, static_cast<uint64_t>(step.thresholdValue));
+    key = ResultCache::combine(key, static_cast<uint64_t>(step.norm));
+    key = ResultCache::combine(key, static_cast<uint64_t>(step.d));
+    for (double v : {step.threshold1, step.threshold2, step.sigmaColor, step.sigmaSpace}) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        key = ResultCache::combine(key, bits);
+    }
+    return key;
+}
+
+// contentHash: hash da entrada, calculado só na primeira consulta à cache (*valid == false)
+ProcessingResult ImageProcessor::runFilter(const cv::Mat& input, uint64_t* contentHash, bool* valid,
+                                           FilterType filter, ProcessingType processing, bool useCache) {
     ProcessingResult result{};
     result.filterType = filter;
     result.processingType = processing;
     result.success = false;
 
+    auto start = std::chrono::high_resolution_clock::now();
+    try {
+        FilterStep step{filter};
+        bool cached = useCache && resultCache.isEnabled();
+        uint64_t key = 0;
+        if (cached) {
+            if (!*valid) {
+                *contentHash = ResultCache::hashImage(input);
+                *valid = true;
+            }
+            key = resultCacheKey(*contentHash, step, processing, precision);
+            result.fromCache = resultCache.lookup(key, result.image);
+        }
+        if (!result.fromCache) {
+            result.image = applyFilterImpl(input, step, processing, precision);
+            if (cached) resultCache.insert(key, result.image);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        result.executionTimeMs = std::chrono::duration<double, std::milli>(end - start).count();
+        result.success = !result.image.empty();
+    } catch (const std::exception& ex) {
+        result.errorMessage = ex.what();
+    }
+    return result;
+}
+
+ProcessingResult ImageProcessor::applyFilter(FilterType filter, ProcessingType processing, bool useCache) {
     if (originalImage.empty()) {
+        ProcessingResult result{};
+        result.filterType = filter;
+        result.processingType = processing;
+        result.success = false;
         result.errorMessage = "Nenhuma imagem carregada";
         return result;
     }
 
+    // O hash da imagem carregada é calculado uma vez e reaproveitado a cada troca de filtro
+    ProcessingResult result = runFilter(originalImage, &originalHash, &originalHashValid, filter, processing, useCache);
+    if (result.success) processedImage = result.image;
+    return result;
+}
+
+ProcessingResult ImageProcessor::processFrame(const cv::Mat& frame, FilterType filter, ProcessingType processing,
+                                              bool useCache) {
+    if (frame.empty()) {
+        ProcessingResult result{};
+        result.filterType = filter;
+        result.processingType = processing;
+        result.success = false;
+        result.errorMessage = "Frame vazio";
+        return result;
+    }
+
+    uint64_t frameHash = 0;
+    bool frameHashValid = false;
+    return runFilter(frame, &frameHash, &frameHashValid, filter, processing, useCache);
+}
+
+ProcessingResult ImageProcessor::processFrame(const cv::Mat& frame, FilterType filter, ProcessingType processing,
+                                              cv::Mat& output) {
+    ProcessingResult result{};
+    result.filterType = filter;
+    result.processingType = processing;
+    result.success = false;
+
+    if (frame.empty()) {
+        result.errorMessage = "Frame vazio";
+        return result;
+    }
+
     auto start = std::chrono::high_resolution_clock::now();
     try {
-        processedImage = applyFilterImpl(originalImage, filter, processing);
+        applyFilterImpl(frame, output, FilterStep{filter}, processing, precision);
         auto end = std::chrono::high_resolution_clock::now();
         result.executionTimeMs = std::chrono::duration<double, std::milli>(end - start).count();
-        result.image = processedImage;
-        result.success = !processedImage.empty();
+        result.image = output;
+        result.success = !output.empty();
     } catch (const std::exception& ex) {
         result.errorMessage = ex.what();
     }
     return result;
 }
 
-ProcessingResult ImageProcessor::processFrame(const cv::Mat& frame, FilterType filter, ProcessingType processing) {
+// ============== Cadeia de filtros ==============
+
+// Raio da vizinhança que um passo lê; -1 quando a saída depende da imagem inteira
+static int stepHalo(const FilterStep& step) {
+    switch (step.filter) {
+        case FilterType::GRAYSCALE:
+        case FilterType::NEGATIVE:
+        case FilterType::SEPIA:
+        case FilterType::THRESHOLD:
+            return 0;
+        case FilterType::SOBEL:
+        case FilterType::SHARPEN:
+        case FilterType::EMBOSS:
+            return 1;
+        case FilterType::BLUR:
+        case FilterType::MEDIAN:
+            return step.kernelSize / 2;
+        case FilterType::GAUSSIAN_BLUR:
+            return utils::useRecursiveGaussian(step.kernelSize) ? -1 : step.kernelSize / 2;
+        case FilterType::BILATERAL:
+            return step.d / 2;
+        case FilterType::CANNY:
+            return -1;
+    }
+    return -1;
+}
+
+static int stepChannels(FilterType filter, int channels) {
+    switch (filter) {
+        case FilterType::GRAYSCALE:
+        case FilterType::SOBEL:
+        case FilterType::CANNY:
+        case FilterType::THRESHOLD:
+            return 1;
+        case FilterType::SEPIA:
+            return 3;
+        default:
+            return channels;
+    }
+}
+
+// Um passo comum ou um grupo de passos pontuais: matriz de cor (opcional) seguida de LUT (opcional)
+struct PipelineOp {
+    size_t firstStep = 0, lastStep = 0;
+    FilterStep step{FilterType::GRAYSCALE};
+    bool pointwise = false;
+    bool hasMatrix = false;
+    utils::ColorMatrix matrix;
+    Precision matrixPrecision = Precision::DOUBLE;
+    bool hasLut = false;
+    utils::PointwiseLut lut;
+};
+
+struct PipelineStage {
+    std::vector<PipelineOp> ops;
+    int halo = 0;          // soma dos halos: margem de cada tile para atravessar todas as operações
+    int channels = 0;      // canais da saída do estágio
+    bool fused = false;    // false: um único passo sobre a imagem inteira, como em applyFilter
+};
+
+static void appendLut(PipelineOp& group, const utils::PointwiseLut& lut) {
+    group.lut = group.hasLut ? utils::composeLut(group.lut, lut) : lut;
+    group.hasLut = true;
+}
+
+// Agrupa passos locais consecutivos num estágio fundido e compila os pontuais em matriz + LUT
+static std::vector<PipelineStage> planPipeline(const std::vector<FilterStep>& steps, int channels,
+                                               bool fuse, Precision precision) {
+    std::vector<PipelineStage> stages;
+    for (size_t s = 0; s < steps.size(); s++) {
+        const FilterStep& step = steps[s];
+        int inChannels = channels;
+        channels = stepChannels(step.filter, channels);
+        int halo = stepHalo(step);
+
+        PipelineOp op;
+        op.firstStep = op.lastStep = s;
+        op.step = step;
+        if (!fuse || halo < 0) {
+            PipelineStage stage;
+            stage.ops.push_back(op);
+            stage.channels = channels;
+            stages.push_back(stage);
+            continue;
+        }
+
+        if (stages.empty() || !stages.back().fused) {
+            stages.emplace_back();
+            stages.back().fused = true;
+        }
+        PipelineStage& stage = stages.back();
+        stage.channels = channels;
+        if (halo > 0) {
+            stage.ops.push_back(op);
+            stage.halo += halo;
+            continue;
+        }
+
+        // Matriz de cor só no início do grupo: depois de uma LUT ou de outra matriz abre um grupo novo
+        PipelineOp* group = !stage.ops.empty() && stage.ops.back().pointwise ? &stage.ops.back() : nullptr;
+        bool needsMatrix = step.filter == FilterType::SEPIA ||
+                           (inChannels == 3 && (step.filter == FilterType::GRAYSCALE || step.filter == FilterType::THRESHOLD));
+        if (!group || (needsMatrix && (group->hasMatrix || group->hasLut))) {
+            op.pointwise = true;
+            stage.ops.push_back(op);
+            group = &stage.ops.back();
+        }
+        group->lastStep = s;
+        switch (step.filter) {
+            case FilterType::GRAYSCALE:
+                if (needsMatrix) {
+                    group->hasMatrix = true;
+                    group->matrix = utils::makeGrayscaleMatrix();
+                    group->matrixPrecision = precision;
+                }
+                break;
+            case FilterType::SEPIA:
+                group->hasMatrix = true;
+                group->matrix = utils::makeSepiaMatrix();
+                group->matrixPrecision = precision;
+                break;
+            case FilterType::THRESHOLD:
+                if (needsMatrix) {
+                    // threshold() converte para cinza com a precisão padrão (DOUBLE)
+                    group->hasMatrix = true;
+                    group->matrix = utils::makeGrayscaleMatrix();
+                    group->matrixPrecision = Precision::DOUBLE;
+                }
+                appendLut(*group, utils::makeThresholdLut(step.thresholdValue));
+                break;
+            case FilterType::NEGATIVE:
+                appendLut(*group, utils::makeNegativeLut());
+                break;
+            default:
+                break;
+        }
+    }
+    return stages;
+}
+
+// processing é SEQUENTIAL ou SIMD (uma thread) dentro dos tiles; o backend completo fora deles
+static cv::Mat runOp(const cv::Mat& input, const PipelineOp& op, ProcessingType processing, Precision precision) {
+    if (!op.pointwise) return applyFilterImpl(input, op.step, processing, precision);
+    const utils::PointwiseLut* lut = op.hasLut ? &op.lut : nullptr;
+    bool simdKernels = processing == ProcessingType::SIMD;
+    if (op.hasMatrix) {
+        return simdKernels ? simd::applyColorMatrix(input, op.matrix, lut, 1)
+                           : sequential::applyColorMatrix(input, op.matrix, lut, op.matrixPrecision);
+    }
+    if (op.hasLut) return simdKernels ? simd::applyLut(input, op.lut, 1) : sequential::applyLut(input, op.lut);
+    return input;
+}
+
+// Cada tile lê sua janela (tile + halo, recortada na imagem) e atravessa todas as operações.
+// Nas bordas da imagem cada operação replica a borda como na imagem inteira; nos cortes internos
+// o erro da borda fica no halo, descartado ao fim: resultado idêntico ao passo a passo.
+static void runFusedStage(const cv::Mat& input, cv::Mat& output, const PipelineStage& stage, int channels,
+                          ProcessingType processing, Precision precision) {
+    bool simdKernels = processing == ProcessingType::SIMD || processing == ProcessingType::SIMD_MULTITHREAD;
+    ProcessingType kernels = simdKernels ? ProcessingType::SIMD : ProcessingType::SEQUENTIAL;
+    int halo = stage.halo;
+
+    if (output.data == input.data) output.release();  // entrada vinda de um buffer interno
+    output.create(input.size(), CV_8UC(channels));
+
+    size_t bytesPerPixel = input.elemSize() * (stage.ops.size() + 1);
+    utils::TileSize tileSize = utils::resolveTileSize(input.size(), bytesPerPixel, halo, halo);
+    std::vector<cv::Rect> tiles = utils::makeTiles(input.size(), tileSize, 0, 0);
+    cv::Rect bounds(0, 0, input.cols, input.rows);
+
+    auto runTiles = [&](int s, int e) {
+        for (int t = s; t < e; t++) {
+            const cv::Rect& region = tiles[t];
+            cv::Rect window = cv::Rect(region.x - halo, region.y - halo,
+                                       region.width + 2 * halo, region.height + 2 * halo) & bounds;
+            cv::Mat current = input(window);
+            for (const PipelineOp& op : stage.ops) current = runOp(current, op, kernels, precision);
+            cv::Mat dst = output(region);
+            current(cv::Rect(region.x - window.x, region.y - window.y, region.width, region.height)).copyTo(dst);
+        }
+    };
+
+    int count = static_cast<int>(tiles.size());
+    switch (processing) {
+        case ProcessingType::PARALLEL:
+            #pragma omp parallel for schedule(dynamic)
+            for (int t = 0; t < count; t++) runTiles(t, t + 1);
+            break;
+        case ProcessingType::MULTITHREAD:
+        case ProcessingType::SIMD_MULTITHREAD:
+            multithread::runInThreads(count, 0, runTiles);
+            break;
+        default:
+            runTiles(0, count);
+            break;
+    }
+}
+
+// Estágio que pode rodar plano a plano: nenhuma operação mistura canais (LUT sem matriz de cor,
+// filtros por canal)
+static bool isPerChannelStage(const PipelineStage& stage) {
+    for (const PipelineOp& op : stage.ops) {
+        if (op.pointwise ? op.hasMatrix : !ImageProcessor::isPerChannelFilter(op.step.filter)) return false;
+    }
+    return true;
+}
+
+PipelineResult ImageProcessor::runPipeline(const cv::Mat& input, const std::vector<FilterStep>& steps,
+                                           ProcessingType processing, bool fuse, bool planar) {
+    PipelineResult result;
+    result.processingType = processing;
+    if (steps.empty()) {
+        result.errorMessage = "Nenhum filtro na cadeia";
+        return result;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    try {
+        std::vector<PipelineStage> stages = planPipeline(steps, input.channels(),
+                                                         fuse && processing != ProcessingType::CUDA, precision);
+        cv::Mat current = input;
+        utils::PlanarImage planes;   // imagem corrente enquanto inPlanar
+        bool inPlanar = false;
+        int next = 0;
+        for (size_t i = 0; i < stages.size(); i++) {
+            const PipelineStage& stage = stages[i];
+            auto stageStart = std::chrono::high_resolution_clock::now();
+            if (planar && isPerChannelStage(stage) && (inPlanar || current.channels() > 1)) {
+                // Separa no primeiro estágio da sequência por canal e reintercala no último
+                if (!inPlanar) {
+                    planes = utils::toPlanar(current);
+                    inPlanar = true;
+                }
+                for (cv::Mat& plane : planes.planes) {
+                    cv::Mat out;
+                    if (stage.fused) {
+                        runFusedStage(plane, out, stage, 1, processing, precision);
+                    } else {
+                        out = applyFilterImpl(plane, stage.ops.front().step, processing, precision);
+                    }
+                    plane = out;
+                }
+                if (i + 1 == stages.size() || !isPerChannelStage(stages[i + 1])) {
+                    current = utils::fromPlanar(planes);
+                    inPlanar = false;
+                }
+            } else {
+                cv::Mat& buffer = pipelineBuffers[next];
+                if (stage.fused) {
+                    runFusedStage(current, buffer, stage, stage.channels, processing, precision);
+                } else {
+                    buffer = applyFilterImpl(current, stage.ops.front().step, processing, precision);
+                }
+                current = buffer;
+                next ^= 1;
+            }
+            auto stageEnd = std::chrono::high_resolution_clock::now();
+
+            StageTiming timing;
+            timing.firstStep = stage.ops.front().firstStep;
+            timing.lastStep = stage.ops.back().lastStep;
+            for (size_t s = timing.firstStep; s <= timing.lastStep; s++) {
+                timing.name += (s == timing.firstStep ? "" : "+") + getFilterName(steps[s].filter);
+            }
+            timing.executionTimeMs = std::chrono::duration<double, std::milli>(stageEnd - stageStart).count();
+            result.stages.push_back(timing);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        result.executionTimeMs = std::chrono::duration<double, std::milli>(end - start).count();
+        result.image = current;
+        result.success = !current.empty();
+    } catch (const std::exception& ex) {
+        result.errorMessage = ex.what();
+    }
+    return result;
+}
+
+PipelineResult ImageProcessor::applyPipeline(const std::vector<FilterStep>& steps, ProcessingType processing, bool fuse,
+                                             bool planar) {
+    if (originalImage.empty()) {
+        PipelineResult result;
+        result.processingType = processing;
+        result.errorMessage = "Nenhuma imagem carregada";
+        return result;
+    }
+    PipelineResult result = runPipeline(originalImage, steps, processing, fuse, planar);
+    if (result.success) processedImage = result.image;
+    return result;
+}
+
+PipelineResult ImageProcessor::processFramePipeline(const cv::Mat& frame, const std::vector<FilterStep>& steps,
+                                                    ProcessingType processing, bool fuse, bool planar) {
+    if (frame.empty()) {
+        PipelineResult result;
+        result.processingType = processing;
+        result.errorMessage = "Frame vazio";
+        return result;
+    }
+    return runPipeline(frame, steps, processing, fuse, planar);
+}
+
+int ImageProcessor::getFilterHalo(FilterType filter) {
+    return stepHalo(FilterStep{filter});
+}
+
+// ============== Região de interesse ==============
+
+// Margem lida em volta da ROI. Canny: Gaussiana 5x5 + Sobel + NMS antes da histerese;
+// Gaussiana recursiva: resposta ao impulso truncada em 4 sigma
+static int roiHalo(const FilterStep& step) {
+    int halo = stepHalo(step);
+    if (halo >= 0) return halo;
+    if (step.filter == FilterType::CANNY) return 4;
+    return static_cast<int>(std::ceil(4.0 * utils::getGaussianSigma(step.kernelSize)));
+}
+
+// Grayscale/Sobel/Canny/Threshold devolvem 1 canal e Sepia 3: ajusta ao destino da composição
+static cv::Mat matchChannels(const cv::Mat& image, int channels) {
+    if (image.channels() == channels) return image;
+    return channels == 3 ? utils::toColor(image) : sequential::grayscale(image);
+}
+
+ProcessingResult ImageProcessor::runFilterROI(const cv::Mat& input, const cv::Rect& roi, FilterType filter,
+                                              ProcessingType processing, RoiOutput output) {
     ProcessingResult result{};
     result.filterType = filter;
     result.processingType = processing;
     result.success = false;
 
-    if (frame.empty()) {
-        result.errorMessage = "Frame vazio";
+    const cv::Rect bounds(0, 0, input.cols, input.rows);
+    const cv::Rect region = roi & bounds;
+    if (region.empty()) {
+        result.errorMessage = "ROI fora da imagem";
         return result;
     }
 
     auto start = std::chrono::high_resolution_clock::now();
     try {
-        cv::Mat out = applyFilterImpl(frame, filter, processing);
+        FilterStep step{filter};
+        int halo = roiHalo(step);
+        cv::Rect window(region.x - halo, region.y - halo, region.width + 2 * halo, region.height + 2 * halo);
+        window &= bounds;
+
+        // A janela é uma vista da entrada: nas bordas da imagem o filtro replica a borda como na
+        // imagem inteira; nos cortes internos o erro fica no halo, descartado no recorte
+        cv::Mat filtered = applyFilterImpl(input(window), step, processing, precision);
+        cv::Mat cropped = filtered(region - window.tl());
+        if (output == RoiOutput::COMPOSE) {
+            result.image = input.clone();
+            matchChannels(cropped, input.channels()).copyTo(result.image(region));
+        } else {
+            result.image = cropped;   // IN_PLACE: applyFilterROI grava o recorte na imagem carregada
+        }
         auto end = std::chrono::high_resolution_clock::now();
         result.executionTimeMs = std::chrono::duration<double, std::milli>(end - start).count();
-        result.image = out;
-        result.success = !out.empty();
+        result.success = !result.image.empty();
     } catch (const std::exception& ex) {
         result.errorMessage = ex.what();
     }
     return result;
 }
 
+ProcessingResult ImageProcessor::applyFilterROI(FilterType filter, ProcessingType processing, const cv::Rect& roi,
+                                                RoiOutput output) {
+    if (originalImage.empty()) {
+        ProcessingResult result{};
+        result.filterType = filter;
+        result.processingType = processing;
+        result.success = false;
+        result.errorMessage = "Nenhuma imagem carregada";
+        return result;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    ProcessingResult result = runFilterROI(originalImage, roi, filter, processing, output);
+    if (result.success && output == RoiOutput::IN_PLACE) {
+        // A imagem carregada pertence ao processador: só aqui a entrada pode ser sobrescrita
+        cv::Mat dst = originalImage(roi & cv::Rect(0, 0, originalImage.cols, originalImage.rows));
+        matchChannels(result.image, originalImage.channels()).copyTo(dst);
+        result.image = originalImage;
+        originalHashValid = false;  // conteúdo da imagem carregada mudou
+        auto end = std::chrono::high_resolution_clock::now();
+        result.executionTimeMs = std::chrono::duration<double, std::milli>(end - start).count();
+    }
+    if (result.success) processedImage = result.image;
+    return result;
+}
+
+ProcessingResult ImageProcessor::processFrameROI(const cv::Mat& frame, const cv::Rect& roi, FilterType filter,
+                                                 ProcessingType processing, RoiOutput output) {
+    if (frame.empty()) {
+        ProcessingResult result{};
+        result.filterType = filter;
+        result.processingType = processing;
+        result.success = false;
+        result.errorMessage = "Frame vazio";
+        return result;
+    }
+    if (output == RoiOutput::IN_PLACE) {
+        // O frame chega por referência const: gravar nele ficaria escondido de quem chama
+        ProcessingResult result{};
+        result.filterType = filter;
+        result.processingType = processing;
+        result.success = false;
+        result.errorMessage = "IN_PLACE só em applyFilterROI; use CROP e copie para o frame";
+        return result;
+    }
+    return runFilterROI(frame, roi, filter, processing, output);
+}
+
 std::string ImageProcessor::getFilterName(FilterType filter) {
     switch (filter) {
         case FilterType::GRAYSCALE: return "Grayscale";
@@ -191,6 +724,8 @@ std::string ImageProcessor::getProcessingName(ProcessingType p) {
         case ProcessingType::PARALLEL: return "Parallel(OpenMP)";
         case ProcessingType::MULTITHREAD: return "Multithread";
         case ProcessingType::CUDA: return "CUDA";
+        case ProcessingType::SIMD: return "SIMD";
+        case ProcessingType::SIMD_MULTITHREAD: return "SIMD+Threads";
     }
     return "Unknown";
 }
@@ -0,0 +1,138 @@
+/**
+ * PAVIC LAB 2025 - IncrementalProcessor
+ * Recalcula só os tiles que mudaram entre quadros consecutivos
+ */
+
+#include "IncrementalProcessor.h"
+#include "SimdFilter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+namespace pavic {
+
+IncrementalProcessor::IncrementalProcessor(int tileSize, double threshold)
+    : tileSize(std::max(8, tileSize)), threshold(threshold) {}
+
+void IncrementalProcessor::setTileSize(int size) {
+    tileSize = std::max(8, size);
+    reset();
+}
+
+void IncrementalProcessor::setPrecision(Precision p) {
+    processor.setPrecision(p);
+    reset();
+}
+
+void IncrementalProcessor::reset() {
+    valid = false;
+    reference.release();
+    output.release();
+}
+
+ProcessingResult IncrementalProcessor::processFrame(const cv::Mat& frame, FilterType filter, ProcessingType processing) {
+    ProcessingResult result{};
+    result.filterType = filter;
+    result.processingType = processing;
+    result.success = false;
+
+    if (frame.empty()) {
+        result.errorMessage = "Frame vazio";
+        return result;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    const int tilesX = (frame.cols + tileSize - 1) / tileSize;
+    const int tilesY = (frame.rows + tileSize - 1) / tileSize;
+    const int halo = ImageProcessor::getFilterHalo(filter);
+    auto tileRect = [&](int tx, int ty) {
+        return cv::Rect(tx * tileSize, ty * tileSize,
+                        std::min(tileSize, frame.cols - tx * tileSize), std::min(tileSize, frame.rows - ty * tileSize));
+    };
+
+    stats = IncrementalStats{};
+    stats.totalTiles = tilesX * tilesY;
+    bool full = !valid || frame.size() != reference.size() || frame.type() != reference.type() ||
+                filter != lastFilter || processing != lastProcessing;
+
+    if (!full) {
+        changed.assign(stats.totalTiles, 0);
+        for (int ty = 0; ty < tilesY; ty++) {
+            for (int tx = 0; tx < tilesX; tx++) {
+                cv::Rect tile = tileRect(tx, ty);
+                uint64_t limit = static_cast<uint64_t>(threshold * tile.area() * frame.channels());
+                if (simd::sumAbsDiff(frame, reference, tile, limit) > limit) {
+                    changed[ty * tilesX + tx] = 1;
+                    stats.changedTiles++;
+                }
+            }
+        }
+        full = halo < 0 && stats.changedTiles > 0;
+    }
+
+    if (full) {
+        // Direto no buffer de saída: sem alocação quando o tamanho do quadro se mantém
+        ProcessingResult whole = processor.processFrame(frame, filter, processing, output);
+        if (!whole.success) {
+            valid = false;
+            return whole;
+        }
+        frame.copyTo(reference);
+        valid = true;
+        lastFilter = filter;
+        lastProcessing = processing;
+        stats.changedTiles = stats.recomputedTiles = stats.totalTiles;
+    } else if (stats.changedTiles > 0) {
+        // Um tile mudado altera a saída até halo pixels além dele: expande a marca pelos vizinhos
+        const int reach = (halo + tileSize - 1) / tileSize;
+        recompute.assign(stats.totalTiles, 0);
+        for (int ty = 0; ty < tilesY; ty++) {
+            for (int tx = 0; tx < tilesX; tx++) {
+                if (!changed[ty * tilesX + tx]) continue;
+                for (int y = std::max(0, ty - reach); y <= std::min(tilesY - 1, ty + reach); y++) {
+                    for (int x = std::max(0, tx - reach); x <= std::min(tilesX - 1, tx + reach); x++) {
+                        recompute[y * tilesX + x] = 1;
+                    }
+                }
+            }
+        }
+
+        // Tiles vizinhos na mesma linha viram uma única ROI: o halo é lido uma vez por trecho
+        for (int ty = 0; ty < tilesY; ty++) {
+            for (int tx = 0; tx < tilesX;) {
+                if (!recompute[ty * tilesX + tx]) { tx++; continue; }
+                int end = tx;
+                while (end < tilesX && recompute[ty * tilesX + end]) end++;
+                cv::Rect run = tileRect(tx, ty) | tileRect(end - 1, ty);
+                ProcessingResult part = processor.processFrameROI(frame, run, filter, processing);
+                if (!part.success) {
+                    valid = false;
+                    return part;
+                }
+                cv::Mat dst = output(run);
+                part.image.copyTo(dst);
+                stats.recomputedTiles += end - tx;
+                tx = end;
+            }
+        }
+
+        // A referência só avança nos tiles mudados: mudanças lentas se acumulam até passar do limiar
+        for (int ty = 0; ty < tilesY; ty++) {
+            for (int tx = 0; tx < tilesX; tx++) {
+                if (!changed[ty * tilesX + tx]) continue;
+                cv::Rect tile = tileRect(tx, ty);
+                cv::Mat dst = reference(tile);
+                frame(tile).copyTo(dst);
+            }
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    stats.recomputeRatio = stats.totalTiles > 0 ? static_cast<double>(stats.recomputedTiles) / stats.totalTiles : 0.0;
+    result.executionTimeMs = std::chrono::duration<double, std::milli>(end - start).count();
+    result.image = output;
+    result.success = !output.empty();
+    return result;
+}
+
+} // namespace pavic
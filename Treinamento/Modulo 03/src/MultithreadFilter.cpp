@@ -1,10 +1,11 @@
 /**
  * PAVIC LAB 2025 - Multithread Filter Implementation
- * Implementação usando std::thread dividindo a imagem por faixas de linhas.
+ * Implementação usando std::thread (pool persistente) dividindo a imagem por faixas de linhas.
  */
 
 #include "MultithreadFilter.h"
 #include "FilterUtils.h"
+#include "ThreadPool.h"
 #include <thread>
 #include <vector>
 #include <functional>
@@ -14,20 +15,14 @@
 namespace pavic {
 namespace multithread {
 
-static void runInThreads(int rows, int numThreads, const std::function<void(int,int)>& worker) {
+void runInThreads(int rows, int numThreads, const std::function<void(int,int)>& worker, int grain) {
     if (numThreads <= 0) numThreads = getOptimalThreadCount();
-    numThreads = std::max(1, std::min(numThreads, rows));
-    int chunk = rows / numThreads;
-    int remainder = rows % numThreads;
-    std::vector<std::thread> ts;
-    int start = 0;
-    for (int t = 0; t < numThreads; ++t) {
-        int extra = (t < remainder) ? 1 : 0;
-        int end = start + chunk + extra;
-        ts.emplace_back([=]() { worker(start, end); });
-        start = end;
-    }
-    for (auto& th : ts) th.join();
+    ThreadPool::global().parallelFor(rows, numThreads, grain, worker);
+}
+
+int grainSize(size_t bytesPerItem) {
+    if (bytesPerItem == 0) return 1;
+    return static_cast<int>(std::max<size_t>(1, (kMinTaskBytes + bytesPerItem - 1) / bytesPerItem));
 }
 
 void processRegion(const cv::Mat& input, cv::Mat& output, int startRow, int endRow,
@@ -40,248 +35,311 @@ int getOptimalThreadCount() {
     return hc > 0 ? static_cast<int>(hc) : 4;
 }
 
-cv::Mat grayscale(const cv::Mat& input, int numThreads) {
-    if (input.empty()) return cv::Mat();
-    if (input.channels() == 1) return input.clone();
-    cv::Mat output(input.rows, input.cols, CV_8UC1);
-    auto worker = [&](int s, int e){
-        for (int i = s; i < e; ++i) {
-            for (int j = 0; j < input.cols; ++j) {
-                cv::Vec3b p = input.at<cv::Vec3b>(i, j);
-                output.at<uchar>(i, j) = static_cast<uchar>(0.299 * p[2] + 0.587 * p[1] + 0.114 * p[0]);
-            }
-        }
-    };
-    runInThreads(input.rows, numThreads, worker);
-    return output;
+void grayscale(const cv::Mat& input, cv::Mat& output, int numThreads, Precision precision) {
+    if (input.empty()) { output.release(); return; }
+    if (input.channels() == 1) { input.copyTo(output); return; }
+    cv::Mat src = input;  // output pode ser a própria entrada: create() troca o buffer dela
+    output.create(src.rows, src.cols, CV_8UC1);
+    auto worker = [&](int s, int e){ utils::grayscaleRows(src, output, s, e, precision); };
+    runInThreads(src.rows, numThreads, worker, grainSize(src.cols * src.elemSize()));
 }
 
-static void applyConvolutionMT(const cv::Mat& input, cv::Mat& output, const cv::Mat& kernel, int numThreads) {
-    int kRows = kernel.rows, kCols = kernel.cols;
-    int kCenterX = kCols / 2, kCenterY = kRows / 2;
-    cv::Mat padded;
-    cv::copyMakeBorder(input, padded, kCenterY, kCenterY, kCenterX, kCenterX, cv::BORDER_REPLICATE);
-    output = cv::Mat::zeros(input.size(), input.type());
+// Tiles 2D com halo (borda virtual: só os tiles de borda copiam); cada thread processa uma faixa contígua de tiles
+static void forEachTile(const cv::Mat& input, cv::Mat& output, int haloY, int haloX, int numThreads,
+                        const std::function<void(const cv::Mat&, cv::Mat&)>& body) {
+    cv::Mat source = utils::detachedInput(input, output);  // saída sobre a entrada
+    utils::TileSize tileSize = utils::resolveTileSize(output.size(), input.elemSize() + output.elemSize(), haloY, haloX);
+    std::vector<cv::Rect> tiles = utils::makeTiles(output.size(), tileSize, haloY, haloX);
     auto worker = [&](int s, int e){
-        for (int i = s; i < e; ++i) {
-            for (int j = 0; j < input.cols; ++j) {
-                if (input.channels() == 1) {
-                    double sum = 0.0;
-                    for (int ki = 0; ki < kRows; ++ki) {
-                        for (int kj = 0; kj < kCols; ++kj) {
-                            int pi = i + ki;
-                            int pj = j + kj;
-                            sum += padded.at<uchar>(pi, pj) * kernel.at<double>(ki, kj);
-                        }
-                    }
-                    output.at<uchar>(i, j) = cv::saturate_cast<uchar>(sum);
-                } else {
-                    double b=0,g=0,r=0;
-                    for (int ki = 0; ki < kRows; ++ki) {
-                        for (int kj = 0; kj < kCols; ++kj) {
-                            int pi = i + ki; int pj = j + kj; double kv = kernel.at<double>(ki, kj);
-                            cv::Vec3b px = padded.at<cv::Vec3b>(pi, pj);
-                            b += px[0]*kv; g += px[1]*kv; r += px[2]*kv;
-                        }
-                    }
-                    output.at<cv::Vec3b>(i, j) = cv::Vec3b(cv::saturate_cast<uchar>(b), cv::saturate_cast<uchar>(g), cv::saturate_cast<uchar>(r));
-                }
-            }
+        for (int t = s; t < e; ++t) {
+            cv::Mat src = utils::sourceWindow(source, tiles[t], haloY, haloX);
+            cv::Mat dst = output(tiles[t]);
+            body(src, dst);
         }
     };
-    runInThreads(input.rows, numThreads, worker);
+    runInThreads(static_cast<int>(tiles.size()), numThreads, worker, grainSize(output.total() * output.elemSize() / tiles.size()));
 }
 
-cv::Mat blur(const cv::Mat& input, int kernelSize, int numThreads) {
-    if (input.empty()) return cv::Mat();
-    cv::Mat kernel = utils::getBoxBlurKernel(kernelSize);
-    cv::Mat output; applyConvolutionMT(input, output, kernel, numThreads); return output;
+static void applyBuiltinConvolutionMT(const cv::Mat& input, cv::Mat& output, utils::BuiltinKernel kernel, int numThreads) {
+    output.create(input.size(), input.type());
+    forEachTile(input, output, 1, 1, numThreads, [&](const cv::Mat& src, cv::Mat& dst){ utils::convolveRows(src, dst, kernel, 0, dst.rows); });
 }
 
-cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize, int numThreads) {
-    if (input.empty()) return cv::Mat();
-    cv::Mat kernel = utils::getGaussianKernel(kernelSize);
-    cv::Mat output; applyConvolutionMT(input, output, kernel, numThreads); return output;
+static void applySeparableConvolutionMT(const cv::Mat& input, cv::Mat& output, const std::vector<double>& kernelX,
+                                        const std::vector<double>& kernelY, int numThreads, Precision precision) {
+    int kx = static_cast<int>(kernelX.size()), ky = static_cast<int>(kernelY.size());
+    int cn = input.channels();
+    cv::Mat temp(input.rows, input.cols, CV_MAKETYPE(utils::separableBufferDepth(precision), cn));
+    forEachTile(input, temp, 0, kx / 2, numThreads,
+                [&](const cv::Mat& src, cv::Mat& dst){ utils::separableRowPass(src, dst, kernelX, 0, dst.rows, precision); });
+    output.create(input.size(), input.type());
+    forEachTile(temp, output, ky / 2, 0, numThreads,
+                [&](const cv::Mat& src, cv::Mat& dst){ utils::separableColumnPass(src, dst, kernelY, 0, dst.rows, precision); });
 }
 
-cv::Mat sobel(const cv::Mat& input, int numThreads) {
-    if (input.empty()) return cv::Mat();
-    cv::Mat gray = input.channels() == 3 ? grayscale(input, numThreads) : input.clone();
-    cv::Mat kx = utils::getSobelKernelX(); cv::Mat ky = utils::getSobelKernelY();
-    cv::Mat gx, gy; applyConvolutionMT(gray, gx, kx, numThreads); applyConvolutionMT(gray, gy, ky, numThreads);
-    cv::Mat out(gray.size(), CV_8UC1);
-    auto worker = [&](int s, int e){
-        for (int i = s; i < e; ++i) {
-            for (int j = 0; j < gray.cols; ++j) {
-                int x = gx.at<uchar>(i, j); int y = gy.at<uchar>(i, j);
-                out.at<uchar>(i, j) = cv::saturate_cast<uchar>(std::sqrt(x*x + y*y));
-            }
-        }
-    };
-    runInThreads(gray.rows, numThreads, worker);
-    return out;
+void blur(const cv::Mat& input, cv::Mat& output, int kernelSize, int numThreads, Precision precision) {
+    if (input.empty()) { output.release(); return; }
+    std::vector<double> kernel = utils::getBoxBlurKernel1D(kernelSize);
+    applySeparableConvolutionMT(input, output, kernel, kernel, numThreads, precision);
 }
 
-cv::Mat canny(const cv::Mat& input, double threshold1, double threshold2, int numThreads) {
-    if (input.empty()) return cv::Mat();
-    cv::Mat gray = input.channels() == 3 ? grayscale(input, numThreads) : input.clone();
-    cv::Mat blurred = gaussianBlur(gray, 5, numThreads);
-    cv::Mat kx = utils::getSobelKernelX(); cv::Mat ky = utils::getSobelKernelY();
-    cv::Mat gx, gy; applyConvolutionMT(blurred, gx, kx, numThreads); applyConvolutionMT(blurred, gy, ky, numThreads);
-    cv::Mat mag(gray.size(), CV_8UC1), dir(gray.size(), CV_64F);
-    auto gradWorker = [&](int s, int e){
+void boxBlur(const cv::Mat& input, cv::Mat& output, int kernelSize, int numThreads) {
+    if (input.empty()) { output.release(); return; }
+    CV_Assert(kernelSize > 0);
+    // Mesma janela de blur: k/2 pixels antes e (k-1)/2 depois
+    int before = kernelSize / 2, after = (kernelSize - 1) / 2;
+    int cn = input.channels(), rowLen = input.cols * cn, area = kernelSize * kernelSize;
+    cv::Mat rowSums(input.rows, input.cols, CV_32SC(cn));
+    auto rowWorker = [&](int s, int e){
         for (int i = s; i < e; ++i) {
-            for (int j = 0; j < gray.cols; ++j) {
-                double x = gx.at<uchar>(i, j) - 128, y = gy.at<uchar>(i, j) - 128;
-                mag.at<uchar>(i, j) = cv::saturate_cast<uchar>(std::sqrt(x*x + y*y));
-                dir.at<double>(i, j) = std::atan2(y, x);
-            }
-        }
-    };
-    runInThreads(gray.rows, numThreads, gradWorker);
-    cv::Mat out(gray.size(), CV_8UC1, cv::Scalar(0));
-    auto nmsWorker = [&](int s, int e){
-        int start = std::max(1, s), end = std::min(e, gray.rows - 1);
-        for (int i = start; i < end; ++i) {
-            for (int j = 1; j < gray.cols - 1; ++j) {
-                double angle = dir.at<double>(i, j) * 180.0 / CV_PI; if (angle < 0) angle += 180;
-                uchar m = mag.at<uchar>(i, j), q = 255, r = 255;
-                if ((angle>=0 && angle<22.5) || (angle>=157.5 && angle<=180)) { q = mag.at<uchar>(i, j+1); r = mag.at<uchar>(i, j-1); }
-                else if (angle>=22.5 && angle<67.5) { q = mag.at<uchar>(i+1, j-1); r = mag.at<uchar>(i-1, j+1); }
-                else if (angle>=67.5 && angle<112.5) { q = mag.at<uchar>(i+1, j); r = mag.at<uchar>(i-1, j); }
-                else if (angle>=112.5 && angle<157.5) { q = mag.at<uchar>(i-1, j-1); r = mag.at<uchar>(i+1, j+1); }
-                if (m>=q && m>=r) {
-                    if (m>=threshold2) out.at<uchar>(i, j)=255; else if (m>=threshold1) out.at<uchar>(i, j)=128;
+            const uchar* src = input.ptr<uchar>(i); int* dst = rowSums.ptr<int>(i);
+            for (int c = 0; c < cn; ++c) {
+                int sum = 0;
+                for (int k = -before; k <= after; ++k) sum += src[std::min(std::max(k, 0), input.cols - 1) * cn + c];
+                dst[c] = sum;
+                for (int j = 1; j < input.cols; ++j) {
+                    sum += src[std::min(j + after, input.cols - 1) * cn + c] - src[std::max(j - before - 1, 0) * cn + c];
+                    dst[j * cn + c] = sum;
                 }
             }
         }
     };
-    runInThreads(gray.rows, numThreads, nmsWorker);
-    // Histerese (sequencial)
-    for (int i = 1; i < gray.rows - 1; ++i) {
-        for (int j = 1; j < gray.cols - 1; ++j) {
-            if (out.at<uchar>(i, j) == 128) {
-                bool strong = false;
-                for (int di=-1; di<=1 && !strong; ++di) for (int dj=-1; dj<=1 && !strong; ++dj) if (out.at<uchar>(i+di,j+dj)==255) strong=true;
-                out.at<uchar>(i, j) = strong ? 255 : 0;
+    const int grain = grainSize(input.cols * input.elemSize());
+    runInThreads(input.rows, numThreads, rowWorker, grain);
+    output.create(input.size(), input.type());  // daqui em diante só rowSums é lido: in-place seguro
+    const int rows = output.rows;
+    // Cada faixa inicializa seus acumuladores de coluna na primeira linha e depois desliza
+    auto colWorker = [&](int s, int e){
+        std::vector<int> colSums(rowLen, 0);
+        for (int k = s - before; k <= s + after; ++k) {
+            const int* src = rowSums.ptr<int>(std::min(std::max(k, 0), rows - 1));
+            for (int j = 0; j < rowLen; ++j) colSums[j] += src[j];
+        }
+        for (int i = s; i < e; ++i) {
+            if (i > s) {
+                const int* in = rowSums.ptr<int>(std::min(i + after, rows - 1));
+                const int* rm = rowSums.ptr<int>(std::max(i - before - 1, 0));
+                for (int j = 0; j < rowLen; ++j) colSums[j] += in[j] - rm[j];
             }
+            uchar* dst = output.ptr<uchar>(i);
+            for (int j = 0; j < rowLen; ++j) dst[j] = cv::saturate_cast<uchar>((colSums[j] + area / 2) / area);
         }
+    };
+    runInThreads(rows, numThreads, colWorker, grain);
+}
+
+void gaussianBlur(const cv::Mat& input, cv::Mat& output, int kernelSize, int numThreads, Precision precision) {
+    if (input.empty()) { output.release(); return; }
+    if (utils::useRecursiveGaussian(kernelSize)) {
+        recursiveGaussianBlur(input, output, utils::getGaussianSigma(kernelSize), numThreads);
+        return;
     }
-    return out;
+    std::vector<double> kernel = utils::getGaussianKernel1D(kernelSize);
+    applySeparableConvolutionMT(input, output, kernel, kernel, numThreads, precision);
+}
+
+void recursiveGaussianBlur(const cv::Mat& input, cv::Mat& output, double sigma, int numThreads) {
+    if (input.empty()) { output.release(); return; }
+    utils::RecursiveGaussianCoeffs coeffs = utils::makeRecursiveGaussianCoeffs(sigma);
+    cv::Mat temp(input.rows, input.cols, CV_32FC(input.channels()));
+    auto rowWorker = [&](int s, int e){ utils::recursiveGaussianRowPass(input, temp, coeffs, s, e); };
+    runInThreads(input.rows, numThreads, rowWorker, grainSize(input.cols * input.elemSize()));
+    // Passe vertical: cada thread fica com uma faixa de colunas e varre todas as linhas
+    output.create(input.size(), input.type());
+    auto colWorker = [&](int s, int e){ utils::recursiveGaussianColumnPass(temp, output, coeffs, s, e); };
+    runInThreads(output.cols * output.channels(), numThreads, colWorker, grainSize(temp.rows * sizeof(float)));
+}
+
+void sobel(const cv::Mat& input, cv::Mat& output, int numThreads, GradientNorm norm) {
+    if (input.empty()) { output.release(); return; }
+    cv::Mat gray = input.channels() == 3 ? grayscale(input, numThreads) : utils::detachedInput(input, output);
+    // Uma passada: gradientes em int16 e magnitude direto na saída
+    output.create(gray.size(), CV_8UC1);
+    runInThreads(gray.rows, numThreads, [&](int s, int e){ utils::sobelRows(gray, output, norm, s, e); }, grainSize(gray.cols));
+}
+
+void canny(const cv::Mat& input, cv::Mat& output, double threshold1, double threshold2, int numThreads) {
+    if (input.empty()) { output.release(); return; }
+    // Cada thread: cinza, Gaussiana, Sobel e NMS em fluxo na sua faixa, seguidos do rótulo da histerese;
+    // as fronteiras (início de cada faixa) são unidas em série
+    cv::Mat src = utils::detachedInput(input, output);
+    output.create(src.size(), CV_8UC1);
+    std::vector<int> labels(output.total());
+    std::vector<char> bandStart(output.rows, 0);
+    const int grain = grainSize(src.cols * src.elemSize());
+    runInThreads(output.rows, numThreads, [&](int s, int e){
+        bandStart[s] = 1;
+        utils::cannyFusedRows(src, output, threshold1, threshold2, s, e);
+        utils::hysteresisLabelRows(output, labels, s, e);
+    }, grain);
+    for (int i = 1; i < output.rows; ++i) if (bandStart[i]) utils::hysteresisMergeRow(labels, output.cols, i);
+    runInThreads(output.rows, numThreads, [&](int s, int e){ utils::hysteresisResolveRows(output, labels, s, e); }, grain);
+}
+
+void sharpen(const cv::Mat& input, cv::Mat& output, int numThreads) {
+    if (input.empty()) { output.release(); return; }
+    applyBuiltinConvolutionMT(input, output, utils::BuiltinKernel::SHARPEN, numThreads);
+}
+
+void emboss(const cv::Mat& input, cv::Mat& output, int numThreads) {
+    if (input.empty()) { output.release(); return; }
+    utils::PointwiseLut bias = utils::makeBiasLut(128);  // +128 no tile, logo após a convolução
+    output.create(input.size(), input.type());
+    forEachTile(input, output, 1, 1, numThreads, [&](const cv::Mat& src, cv::Mat& dst){
+        utils::convolveRows(src, dst, utils::BuiltinKernel::EMBOSS, 0, dst.rows);
+        utils::applyLutRows(dst, dst, bias, 0, dst.rows);
+    });
+}
+
+void negative(const cv::Mat& input, cv::Mat& output, int numThreads) {
+    applyLut(input, output, utils::makeNegativeLut(), numThreads);
+}
+
+void sepia(const cv::Mat& input, cv::Mat& output, int numThreads, Precision precision) {
+    if (input.empty()) { output.release(); return; }
+    cv::Mat color = input.channels()==1 ? utils::toColor(input) : input;
+    output.create(color.size(), CV_8UC3);
+    auto worker = [&](int s, int e){ utils::sepiaRows(color, output, s, e, precision); };
+    runInThreads(color.rows, numThreads, worker, grainSize(color.cols * color.elemSize()));
+}
+
+void threshold(const cv::Mat& input, cv::Mat& output, int thresholdValue, int numThreads) {
+    if (input.empty()) { output.release(); return; }
+    utils::PointwiseLut lut = utils::makeThresholdLut(thresholdValue);  // cor: cinza + limiar numa passada
+    if (input.channels()==3) applyColorMatrix(input, output, utils::makeGrayscaleMatrix(), &lut, numThreads);
+    else applyLut(input, output, lut, numThreads);
+}
+
+void applyColorMatrix(const cv::Mat& input, cv::Mat& output, const utils::ColorMatrix& matrix,
+                      const utils::PointwiseLut* lut, int numThreads, Precision precision) {
+    if (input.empty()) { output.release(); return; }
+    cv::Mat color = input.channels()==1 ? utils::toColor(input) : input;
+    output.create(color.size(), CV_8UC(matrix.outChannels));
+    auto worker = [&](int s, int e){ utils::colorMatrixRows(color, output, matrix, s, e, precision, lut); };
+    runInThreads(color.rows, numThreads, worker, grainSize(color.cols * color.elemSize()));
+}
+
+void applyLut(const cv::Mat& input, cv::Mat& output, const utils::PointwiseLut& lut, int numThreads) {
+    if (input.empty()) { output.release(); return; }
+    output.create(input.size(), input.type());
+    auto worker = [&](int s, int e){ utils::applyLutRows(input, output, lut, s, e); };
+    runInThreads(output.rows, numThreads, worker, grainSize(output.cols * output.elemSize()));
+}
+
+void median(const cv::Mat& input, cv::Mat& output, int kernelSize, int numThreads) {
+    if (input.empty()) { output.release(); return; }
+    int k = kernelSize/2;
+    output.create(input.size(), input.type());
+    forEachTile(input, output, k, k, numThreads, [&](const cv::Mat& src, cv::Mat& dst){ utils::medianRows(src, dst, kernelSize, 0, dst.rows); });
+}
+
+void bilateral(const cv::Mat& input, cv::Mat& output, int d, double sigmaColor, double sigmaSpace, int numThreads,
+               Precision precision) {
+    if (input.empty()) { output.release(); return; }
+    int radius = d/2;
+    utils::BilateralWeights weights = utils::makeBilateralWeights(d, sigmaColor, sigmaSpace, precision);
+    output.create(input.size(), input.type());
+    forEachTile(input, output, radius, radius, numThreads, [&](const cv::Mat& src, cv::Mat& dst){ utils::bilateralRows(src, dst, weights, 0, dst.rows); });
+}
+
+// Versões que devolvem uma imagem nova
+
+cv::Mat grayscale(const cv::Mat& input, int numThreads, Precision precision) {
+    cv::Mat output;
+    grayscale(input, output, numThreads, precision);
+    return output;
+}
+
+cv::Mat blur(const cv::Mat& input, int kernelSize, int numThreads, Precision precision) {
+    cv::Mat output;
+    blur(input, output, kernelSize, numThreads, precision);
+    return output;
+}
+
+cv::Mat boxBlur(const cv::Mat& input, int kernelSize, int numThreads) {
+    cv::Mat output;
+    boxBlur(input, output, kernelSize, numThreads);
+    return output;
+}
+
+cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize, int numThreads, Precision precision) {
+    cv::Mat output;
+    gaussianBlur(input, output, kernelSize, numThreads, precision);
+    return output;
+}
+
+cv::Mat recursiveGaussianBlur(const cv::Mat& input, double sigma, int numThreads) {
+    cv::Mat output;
+    recursiveGaussianBlur(input, output, sigma, numThreads);
+    return output;
+}
+
+cv::Mat sobel(const cv::Mat& input, int numThreads, GradientNorm norm) {
+    cv::Mat output;
+    sobel(input, output, numThreads, norm);
+    return output;
+}
+
+cv::Mat canny(const cv::Mat& input, double threshold1, double threshold2, int numThreads) {
+    cv::Mat output;
+    canny(input, output, threshold1, threshold2, numThreads);
+    return output;
 }
 
 cv::Mat sharpen(const cv::Mat& input, int numThreads) {
-    if (input.empty()) return cv::Mat();
-    cv::Mat k = utils::getSharpenKernel(); cv::Mat out; applyConvolutionMT(input, out, k, numThreads); return out;
+    cv::Mat output;
+    sharpen(input, output, numThreads);
+    return output;
 }
 
 cv::Mat emboss(const cv::Mat& input, int numThreads) {
-    if (input.empty()) return cv::Mat();
-    cv::Mat k = utils::getEmbossKernel(); cv::Mat out; applyConvolutionMT(input, out, k, numThreads);
-    auto worker = [&](int s, int e){
-        for (int i = s; i < e; ++i) {
-            for (int j = 0; j < out.cols; ++j) {
-                if (out.channels()==1) out.at<uchar>(i,j) = cv::saturate_cast<uchar>(out.at<uchar>(i,j)+128);
-                else { auto& p = out.at<cv::Vec3b>(i,j); p[0]=cv::saturate_cast<uchar>(p[0]+128); p[1]=cv::saturate_cast<uchar>(p[1]+128); p[2]=cv::saturate_cast<uchar>(p[2]+128); }
-            }
-        }
-    }; runInThreads(out.rows, numThreads, worker);
-    return out;
+    cv::Mat output;
+    emboss(input, output, numThreads);
+    return output;
 }
 
 cv::Mat negative(const cv::Mat& input, int numThreads) {
-    if (input.empty()) return cv::Mat();
-    cv::Mat out = input.clone();
-    auto worker = [&](int s, int e){
-        for (int i = s; i < e; ++i) {
-            for (int j = 0; j < input.cols; ++j) {
-                if (input.channels()==1) out.at<uchar>(i,j) = 255 - input.at<uchar>(i,j);
-                else { auto p = input.at<cv::Vec3b>(i,j); out.at<cv::Vec3b>(i,j) = cv::Vec3b(255-p[0],255-p[1],255-p[2]); }
-            }
-        }
-    }; runInThreads(input.rows, numThreads, worker);
-    return out;
+    cv::Mat output;
+    negative(input, output, numThreads);
+    return output;
 }
 
-cv::Mat sepia(const cv::Mat& input, int numThreads) {
-    if (input.empty()) return cv::Mat();
-    cv::Mat color = input.channels()==1 ? utils::toColor(input) : input.clone();
-    cv::Mat out = color.clone();
-    auto worker = [&](int s, int e){
-        for (int i = s; i < e; ++i) {
-            for (int j = 0; j < color.cols; ++j) {
-                cv::Vec3b p = color.at<cv::Vec3b>(i,j); int b=p[0], g=p[1], r=p[2];
-                int nr = static_cast<int>(0.393*r + 0.769*g + 0.189*b);
-                int ng = static_cast<int>(0.349*r + 0.686*g + 0.168*b);
-                int nb = static_cast<int>(0.272*r + 0.534*g + 0.131*b);
-                out.at<cv::Vec3b>(i,j) = cv::Vec3b(cv::saturate_cast<uchar>(nb), cv::saturate_cast<uchar>(ng), cv::saturate_cast<uchar>(nr));
-            }
-        }
-    }; runInThreads(color.rows, numThreads, worker);
-    return out;
+cv::Mat sepia(const cv::Mat& input, int numThreads, Precision precision) {
+    cv::Mat output;
+    sepia(input, output, numThreads, precision);
+    return output;
 }
 
 cv::Mat threshold(const cv::Mat& input, int thresholdValue, int numThreads) {
-    if (input.empty()) return cv::Mat();
-    cv::Mat gray = input.channels()==3 ? grayscale(input, numThreads) : input.clone();
-    cv::Mat out(gray.size(), CV_8UC1);
-    auto worker = [&](int s, int e){
-        for (int i = s; i < e; ++i) {
-            for (int j = 0; j < gray.cols; ++j) out.at<uchar>(i,j) = gray.at<uchar>(i,j) > thresholdValue ? 255 : 0;
-        }
-    }; runInThreads(gray.rows, numThreads, worker);
-    return out;
+    cv::Mat output;
+    threshold(input, output, thresholdValue, numThreads);
+    return output;
 }
 
 cv::Mat median(const cv::Mat& input, int kernelSize, int numThreads) {
-    if (input.empty()) return cv::Mat();
-    int k = kernelSize/2; cv::Mat padded; cv::copyMakeBorder(input, padded, k,k,k,k, cv::BORDER_REPLICATE);
-    cv::Mat out = cv::Mat::zeros(input.size(), input.type());
-    auto worker = [&](int s, int e){
-        for (int i = s; i < e; ++i) {
-            for (int j = 0; j < input.cols; ++j) {
-                if (input.channels()==1) {
-                    std::vector<uchar> vals(kernelSize*kernelSize); int idx=0;
-                    for (int ki=0; ki<kernelSize; ++ki) for (int kj=0; kj<kernelSize; ++kj) vals[idx++] = padded.at<uchar>(i+ki, j+kj);
-                    std::sort(vals.begin(), vals.begin()+idx); out.at<uchar>(i,j) = vals[idx/2];
-                } else {
-                    std::vector<uchar> vb(kernelSize*kernelSize), vg(kernelSize*kernelSize), vr(kernelSize*kernelSize); int idx=0;
-                    for (int ki=0; ki<kernelSize; ++ki) for (int kj=0; kj<kernelSize; ++kj) { auto p=padded.at<cv::Vec3b>(i+ki,j+kj); vb[idx]=p[0]; vg[idx]=p[1]; vr[idx]=p[2]; ++idx; }
-                    std::sort(vb.begin(), vb.begin()+idx); std::sort(vg.begin(), vg.begin()+idx); std::sort(vr.begin(), vr.begin()+idx);
-                    out.at<cv::Vec3b>(i,j) = cv::Vec3b(vb[idx/2], vg[idx/2], vr[idx/2]);
-                }
-            }
-        }
-    }; runInThreads(input.rows, numThreads, worker);
-    return out;
+    cv::Mat output;
+    median(input, output, kernelSize, numThreads);
+    return output;
 }
 
-cv::Mat bilateral(const cv::Mat& input, int d, double sigmaColor, double sigmaSpace, int numThreads) {
-    if (input.empty()) return cv::Mat();
-    int radius = d/2; cv::Mat padded; cv::copyMakeBorder(input, padded, radius,radius,radius,radius, cv::BORDER_REPLICATE);
-    cv::Mat out = cv::Mat::zeros(input.size(), input.type());
-    std::vector<std::vector<double>> spatial(d, std::vector<double>(d));
-    for (int i=0;i<d;++i) for (int j=0;j<d;++j) { int dx=i-radius, dy=j-radius; spatial[i][j] = std::exp(-(dx*dx+dy*dy)/(2*sigmaSpace*sigmaSpace)); }
-    auto worker = [&](int s, int e){
-        for (int i = s; i < e; ++i) {
-            for (int j = 0; j < input.cols; ++j) {
-                if (input.channels()==1) {
-                    double sw=0.0, sv=0.0; uchar c = padded.at<uchar>(i+radius, j+radius);
-                    for (int ki=0; ki<d; ++ki) for (int kj=0; kj<d; ++kj) { uchar n=padded.at<uchar>(i+ki,j+kj); double cw=std::exp(-((c-n)*(c-n))/(2*sigmaColor*sigmaColor)); double w=spatial[ki][kj]*cw; sw+=w; sv+=w*n; }
-                    out.at<uchar>(i,j) = cv::saturate_cast<uchar>(sv/sw);
-                } else {
-                    double swb=0, swg=0, swr=0, sb=0, sg=0, sr=0; auto c=padded.at<cv::Vec3b>(i+radius,j+radius);
-                    for (int ki=0; ki<d; ++ki) for (int kj=0; kj<d; ++kj) { auto n=padded.at<cv::Vec3b>(i+ki,j+kj);
-                        for (int ch=0; ch<3; ++ch) { double cd=(c[ch]-n[ch]); double cw=std::exp(-(cd*cd)/(2*sigmaColor*sigmaColor)); double w=spatial[ki][kj]*cw;
-                            if (ch==0) { swb+=w; sb+=w*n[0]; } else if (ch==1) { swg+=w; sg+=w*n[1]; } else { swr+=w; sr+=w*n[2]; }
-                        }
-                    }
-                    out.at<cv::Vec3b>(i,j) = cv::Vec3b(cv::saturate_cast<uchar>(sb/swb), cv::saturate_cast<uchar>(sg/swg), cv::saturate_cast<uchar>(sr/swr));
-                }
-            }
-        }
-    }; runInThreads(input.rows, numThreads, worker);
-    return out;
+cv::Mat bilateral(const cv::Mat& input, int d, double sigmaColor, double sigmaSpace, int numThreads,
+                  Precision precision) {
+    cv::Mat output;
+    bilateral(input, output, d, sigmaColor, sigmaSpace, numThreads, precision);
+    return output;
+}
+
+cv::Mat applyLut(const cv::Mat& input, const utils::PointwiseLut& lut, int numThreads) {
+    cv::Mat output;
+    applyLut(input, output, lut, numThreads);
+    return output;
+}
+
+cv::Mat applyColorMatrix(const cv::Mat& input, const utils::ColorMatrix& matrix,
+                         const utils::PointwiseLut* lut, int numThreads, Precision precision) {
+    cv::Mat output;
+    applyColorMatrix(input, output, matrix, lut, numThreads, precision);
+    return output;
 }
 
 } // namespace multithread
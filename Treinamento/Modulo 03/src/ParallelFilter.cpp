@@ -8,418 +8,409 @@
 #include <omp.h>
 #include <cmath>
 #include <algorithm>
+#include <functional>
 
 namespace pavic {
 namespace parallel {
 
-void applyConvolutionParallel(const cv::Mat& input, cv::Mat& output, const cv::Mat& kernel) {
-    int kRows = kernel.rows;
-    int kCols = kernel.cols;
-    int kCenterX = kCols / 2;
-    int kCenterY = kRows / 2;
-    
-    cv::Mat padded;
-    cv::copyMakeBorder(input, padded, kCenterY, kCenterY, kCenterX, kCenterX, cv::BORDER_REPLICATE);
-    
-    output = cv::Mat::zeros(input.size(), input.type());
-    
-    #pragma omp parallel for collapse(2)
-    for (int i = 0; i < input.rows; i++) {
-        for (int j = 0; j < input.cols; j++) {
-            if (input.channels() == 1) {
-                double sum = 0.0;
-                for (int ki = 0; ki < kRows; ki++) {
-                    for (int kj = 0; kj < kCols; kj++) {
-                        int pi = i + ki;
-                        int pj = j + kj;
-                        sum += padded.at<uchar>(pi, pj) * kernel.at<double>(ki, kj);
-                    }
-                }
-                output.at<uchar>(i, j) = cv::saturate_cast<uchar>(sum);
-            } else if (input.channels() == 3) {
-                double sumB = 0.0, sumG = 0.0, sumR = 0.0;
-                for (int ki = 0; ki < kRows; ki++) {
-                    for (int kj = 0; kj < kCols; kj++) {
-                        int pi = i + ki;
-                        int pj = j + kj;
-                        cv::Vec3b pixel = padded.at<cv::Vec3b>(pi, pj);
-                        double kVal = kernel.at<double>(ki, kj);
-                        sumB += pixel[0] * kVal;
-                        sumG += pixel[1] * kVal;
-                        sumR += pixel[2] * kVal;
-                    }
-                }
-                output.at<cv::Vec3b>(i, j) = cv::Vec3b(
-                    cv::saturate_cast<uchar>(sumB),
-                    cv::saturate_cast<uchar>(sumG),
-                    cv::saturate_cast<uchar>(sumR)
-                );
-            }
-        }
+// Tiles 2D com halo distribuídos dinamicamente: body recebe a janela (tile + halo) e a ROI da saída.
+// O interior é lido direto de input; só os tiles das faixas de borda copiam uma janela replicada.
+static void forEachTile(const cv::Mat& input, cv::Mat& output, int haloY, int haloX,
+                        const std::function<void(const cv::Mat&, cv::Mat&)>& body) {
+    // Saída no mesmo buffer da entrada: a leitura direta exige uma cópia
+    cv::Mat source = utils::detachedInput(input, output);
+    utils::TileSize tileSize = utils::resolveTileSize(output.size(), input.elemSize() + output.elemSize(), haloY, haloX);
+    std::vector<cv::Rect> tiles = utils::makeTiles(output.size(), tileSize, haloY, haloX);
+    
+    #pragma omp parallel for schedule(dynamic)
+    for (int t = 0; t < static_cast<int>(tiles.size()); t++) {
+        cv::Mat src = utils::sourceWindow(source, tiles[t], haloY, haloX);
+        cv::Mat dst = output(tiles[t]);
+        body(src, dst);
     }
 }
 
-cv::Mat grayscale(const cv::Mat& input) {
-    if (input.empty()) return cv::Mat();
+void applyConvolutionParallel(const cv::Mat& input, cv::Mat& output, const cv::Mat& kernel, Precision precision) {
+    int kCenterX = kernel.cols / 2;
+    int kCenterY = kernel.rows / 2;
+    
+    output.create(input.size(), input.type());
+    forEachTile(input, output, kCenterY, kCenterX, [&](const cv::Mat& src, cv::Mat& dst) {
+        utils::convolveRows(src, dst, kernel, 0, dst.rows, precision);
+    });
+}
+
+void applyBuiltinConvolutionParallel(const cv::Mat& input, cv::Mat& output, utils::BuiltinKernel kernel) {
+    output.create(input.size(), input.type());
+    forEachTile(input, output, 1, 1, [&](const cv::Mat& src, cv::Mat& dst) {
+        utils::convolveRows(src, dst, kernel, 0, dst.rows);
+    });
+}
+
+void applySeparableConvolutionParallel(const cv::Mat& input, cv::Mat& output,
+                                       const std::vector<double>& kernelX, const std::vector<double>& kernelY,
+                                       Precision precision) {
+    int kx = static_cast<int>(kernelX.size());
+    int ky = static_cast<int>(kernelY.size());
+    int cn = input.channels();
+    
+    cv::Mat temp(input.rows, input.cols, CV_MAKETYPE(utils::separableBufferDepth(precision), cn));
+    forEachTile(input, temp, 0, kx / 2, [&](const cv::Mat& src, cv::Mat& dst) {
+        utils::separableRowPass(src, dst, kernelX, 0, dst.rows, precision);
+    });
+    
+    // Passe vertical em tiles: as ky linhas de cada coluna do tile continuam na cache
+    output.create(input.size(), input.type());
+    forEachTile(temp, output, ky / 2, 0, [&](const cv::Mat& src, cv::Mat& dst) {
+        utils::separableColumnPass(src, dst, kernelY, 0, dst.rows, precision);
+    });
+}
+
+void grayscale(const cv::Mat& input, cv::Mat& output, Precision precision) {
+    if (input.empty()) { output.release(); return; }
     
     if (input.channels() == 1) {
-        return input.clone();
+        input.copyTo(output);
+        return;
     }
     
-    cv::Mat output(input.rows, input.cols, CV_8UC1);
+    cv::Mat src = input;  // output pode ser a própria entrada: create() troca o buffer dela
+    output.create(src.rows, src.cols, CV_8UC1);
     
-    #pragma omp parallel for collapse(2)
-    for (int i = 0; i < input.rows; i++) {
-        for (int j = 0; j < input.cols; j++) {
-            cv::Vec3b pixel = input.at<cv::Vec3b>(i, j);
-            uchar gray = static_cast<uchar>(0.299 * pixel[2] + 0.587 * pixel[1] + 0.114 * pixel[0]);
-            output.at<uchar>(i, j) = gray;
-        }
+    #pragma omp parallel for
+    for (int i = 0; i < src.rows; i++) {
+        utils::grayscaleRows(src, output, i, i + 1, precision);
     }
+}
+
+void blur(const cv::Mat& input, cv::Mat& output, int kernelSize, Precision precision) {
+    if (input.empty()) { output.release(); return; }
     
-    return output;
+    std::vector<double> kernel = utils::getBoxBlurKernel1D(kernelSize);
+    applySeparableConvolutionParallel(input, output, kernel, kernel, precision);
 }
 
-cv::Mat blur(const cv::Mat& input, int kernelSize) {
-    if (input.empty()) return cv::Mat();
+void boxBlur(const cv::Mat& input, cv::Mat& output, int kernelSize) {
+    if (input.empty()) { output.release(); return; }
+    CV_Assert(kernelSize > 0);
+    
+    // Mesma janela de blur: k/2 pixels antes e (k-1)/2 depois
+    int before = kernelSize / 2, after = (kernelSize - 1) / 2;
+    int cn = input.channels();
+    int rowLen = input.cols * cn;
+    int area = kernelSize * kernelSize;
+    
+    // Passe horizontal: cada linha é independente
+    cv::Mat rowSums(input.rows, input.cols, CV_32SC(cn));
+    #pragma omp parallel for
+    for (int i = 0; i < input.rows; i++) {
+        const uchar* src = input.ptr<uchar>(i);
+        int* dst = rowSums.ptr<int>(i);
+        for (int c = 0; c < cn; c++) {
+            int sum = 0;
+            for (int k = -before; k <= after; k++) {
+                sum += src[std::min(std::max(k, 0), input.cols - 1) * cn + c];
+            }
+            dst[c] = sum;
+            for (int j = 1; j < input.cols; j++) {
+                int in = std::min(j + after, input.cols - 1);
+                int out = std::max(j - before - 1, 0);
+                sum += src[in * cn + c] - src[out * cn + c];
+                dst[j * cn + c] = sum;
+            }
+        }
+    }
     
-    cv::Mat kernel = utils::getBoxBlurKernel(kernelSize);
-    cv::Mat output;
-    applyConvolutionParallel(input, output, kernel);
-    return output;
+    // Passe vertical: cada thread desliza seus acumuladores sobre uma faixa contígua de linhas.
+    // Só lê rowSums, então output pode ser a própria entrada
+    output.create(input.size(), input.type());
+    const int rows = output.rows;
+    #pragma omp parallel
+    {
+        int nThreads = omp_get_num_threads();
+        int tid = omp_get_thread_num();
+        int start = static_cast<int>(static_cast<long long>(rows) * tid / nThreads);
+        int end = static_cast<int>(static_cast<long long>(rows) * (tid + 1) / nThreads);
+        
+        std::vector<int> colSums(rowLen, 0);
+        for (int k = start - before; k <= start + after && start < end; k++) {
+            const int* src = rowSums.ptr<int>(std::min(std::max(k, 0), rows - 1));
+            for (int j = 0; j < rowLen; j++) colSums[j] += src[j];
+        }
+        for (int i = start; i < end; i++) {
+            if (i > start) {
+                const int* in = rowSums.ptr<int>(std::min(i + after, rows - 1));
+                const int* out = rowSums.ptr<int>(std::max(i - before - 1, 0));
+                for (int j = 0; j < rowLen; j++) colSums[j] += in[j] - out[j];
+            }
+            uchar* dst = output.ptr<uchar>(i);
+            for (int j = 0; j < rowLen; j++) {
+                dst[j] = cv::saturate_cast<uchar>((colSums[j] + area / 2) / area);
+            }
+        }
+    }
 }
 
-cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize) {
-    if (input.empty()) return cv::Mat();
+void gaussianBlur(const cv::Mat& input, cv::Mat& output, int kernelSize, Precision precision) {
+    if (input.empty()) { output.release(); return; }
     
-    cv::Mat kernel = utils::getGaussianKernel(kernelSize);
-    cv::Mat output;
-    applyConvolutionParallel(input, output, kernel);
-    return output;
+    if (utils::useRecursiveGaussian(kernelSize)) {
+        recursiveGaussianBlur(input, output, utils::getGaussianSigma(kernelSize));
+        return;
+    }
+    
+    std::vector<double> kernel = utils::getGaussianKernel1D(kernelSize);
+    applySeparableConvolutionParallel(input, output, kernel, kernel, precision);
 }
 
-cv::Mat sobel(const cv::Mat& input) {
-    if (input.empty()) return cv::Mat();
+void recursiveGaussianBlur(const cv::Mat& input, cv::Mat& output, double sigma) {
+    if (input.empty()) { output.release(); return; }
     
-    cv::Mat gray = input.channels() == 3 ? grayscale(input) : input.clone();
+    utils::RecursiveGaussianCoeffs coeffs = utils::makeRecursiveGaussianCoeffs(sigma);
+    cv::Mat temp(input.rows, input.cols, CV_32FC(input.channels()));
     
-    cv::Mat kernelX = utils::getSobelKernelX();
-    cv::Mat kernelY = utils::getSobelKernelY();
+    #pragma omp parallel for
+    for (int i = 0; i < input.rows; i++) {
+        utils::recursiveGaussianRowPass(input, temp, coeffs, i, i + 1);
+    }
     
-    cv::Mat gradX, gradY;
-    applyConvolutionParallel(gray, gradX, kernelX);
-    applyConvolutionParallel(gray, gradY, kernelY);
+    // Passe vertical em blocos de colunas: cada thread varre as linhas do seu bloco
+    output.create(input.size(), input.type());
+    int rowLen = output.cols * output.channels();
+    const int block = 64;
+    #pragma omp parallel for
+    for (int start = 0; start < rowLen; start += block) {
+        utils::recursiveGaussianColumnPass(temp, output, coeffs, start, std::min(start + block, rowLen));
+    }
+}
+
+void sobel(const cv::Mat& input, cv::Mat& output, GradientNorm norm) {
+    if (input.empty()) { output.release(); return; }
     
-    cv::Mat output(gray.size(), CV_8UC1);
+    cv::Mat gray = input.channels() == 3 ? grayscale(input) : utils::detachedInput(input, output);
     
-    #pragma omp parallel for collapse(2)
+    // Uma passada: vizinhança 3x3 lida uma vez, gradientes em int16, magnitude direto na saída
+    output.create(gray.size(), CV_8UC1);
+    #pragma omp parallel for
     for (int i = 0; i < gray.rows; i++) {
-        for (int j = 0; j < gray.cols; j++) {
-            int gx = gradX.at<uchar>(i, j);
-            int gy = gradY.at<uchar>(i, j);
-            int magnitude = static_cast<int>(std::sqrt(gx * gx + gy * gy));
-            output.at<uchar>(i, j) = cv::saturate_cast<uchar>(magnitude);
+        utils::sobelRows(gray, output, norm, i, i + 1);
+    }
+}
+
+void canny(const cv::Mat& input, cv::Mat& output, double threshold1, double threshold2) {
+    if (input.empty()) { output.release(); return; }
+    
+    // Cada thread processa uma faixa de linhas em fluxo (cinza, Gaussiana, Sobel, NMS) e já
+    // rotula sua faixa para a histerese; as fronteiras são unidas em série
+    cv::Mat src = utils::detachedInput(input, output);
+    output.create(src.size(), CV_8UC1);
+    std::vector<int> labels(output.total());
+    #pragma omp parallel
+    {
+        int nThreads = omp_get_num_threads();
+        int tid = omp_get_thread_num();
+        int start = static_cast<int>(static_cast<long long>(output.rows) * tid / nThreads);
+        int end = static_cast<int>(static_cast<long long>(output.rows) * (tid + 1) / nThreads);
+        
+        utils::cannyFusedRows(src, output, threshold1, threshold2, start, end);
+        utils::hysteresisLabelRows(output, labels, start, end);
+        #pragma omp barrier
+        #pragma omp single
+        {
+            for (int t = 1; t < nThreads; t++)
+                utils::hysteresisMergeRow(labels, output.cols, static_cast<int>(static_cast<long long>(output.rows) * t / nThreads));
         }
+        utils::hysteresisResolveRows(output, labels, start, end);
     }
+}
+
+void sharpen(const cv::Mat& input, cv::Mat& output) {
+    if (input.empty()) { output.release(); return; }
     
-    return output;
+    applyBuiltinConvolutionParallel(input, output, utils::BuiltinKernel::SHARPEN);
 }
 
-cv::Mat canny(const cv::Mat& input, double threshold1, double threshold2) {
-    if (input.empty()) return cv::Mat();
+void emboss(const cv::Mat& input, cv::Mat& output) {
+    if (input.empty()) { output.release(); return; }
+    
+    // +128 aplicado no próprio tile, logo após a convolução
+    utils::PointwiseLut bias = utils::makeBiasLut(128);
+    output.create(input.size(), input.type());
+    forEachTile(input, output, 1, 1, [&](const cv::Mat& src, cv::Mat& dst) {
+        utils::convolveRows(src, dst, utils::BuiltinKernel::EMBOSS, 0, dst.rows);
+        utils::applyLutRows(dst, dst, bias, 0, dst.rows);
+    });
+}
+
+void negative(const cv::Mat& input, cv::Mat& output) {
+    applyLut(input, output, utils::makeNegativeLut());
+}
+
+void sepia(const cv::Mat& input, cv::Mat& output, Precision precision) {
+    if (input.empty()) { output.release(); return; }
     
-    cv::Mat gray = input.channels() == 3 ? grayscale(input) : input.clone();
-    cv::Mat blurred = gaussianBlur(gray, 5);
+    cv::Mat colorInput = input.channels() == 1 ? utils::toColor(input) : input;
+    output.create(colorInput.size(), CV_8UC3);
     
-    cv::Mat gradX, gradY;
-    cv::Mat kernelX = utils::getSobelKernelX();
-    cv::Mat kernelY = utils::getSobelKernelY();
+    #pragma omp parallel for
+    for (int i = 0; i < colorInput.rows; i++) {
+        utils::sepiaRows(colorInput, output, i, i + 1, precision);
+    }
+}
+
+void threshold(const cv::Mat& input, cv::Mat& output, int thresholdValue) {
+    if (input.empty()) { output.release(); return; }
     
-    applyConvolutionParallel(blurred, gradX, kernelX);
-    applyConvolutionParallel(blurred, gradY, kernelY);
+    // Cor: cinza e limiar na mesma passada, sem a imagem cinza intermediária
+    utils::PointwiseLut lut = utils::makeThresholdLut(thresholdValue);
+    if (input.channels() == 3) applyColorMatrix(input, output, utils::makeGrayscaleMatrix(), &lut);
+    else applyLut(input, output, lut);
+}
+
+void applyColorMatrix(const cv::Mat& input, cv::Mat& output, const utils::ColorMatrix& matrix,
+                      const utils::PointwiseLut* lut, Precision precision) {
+    if (input.empty()) { output.release(); return; }
     
-    cv::Mat magnitude(gray.size(), CV_8UC1);
-    cv::Mat direction(gray.size(), CV_64F);
+    cv::Mat color = input.channels() == 1 ? utils::toColor(input) : input;
+    output.create(color.size(), CV_8UC(matrix.outChannels));
     
-    #pragma omp parallel for collapse(2)
-    for (int i = 0; i < gray.rows; i++) {
-        for (int j = 0; j < gray.cols; j++) {
-            double gx = gradX.at<uchar>(i, j) - 128;
-            double gy = gradY.at<uchar>(i, j) - 128;
-            magnitude.at<uchar>(i, j) = cv::saturate_cast<uchar>(std::sqrt(gx * gx + gy * gy));
-            direction.at<double>(i, j) = std::atan2(gy, gx);
-        }
+    #pragma omp parallel for
+    for (int i = 0; i < color.rows; i++) {
+        utils::colorMatrixRows(color, output, matrix, i, i + 1, precision, lut);
     }
+}
+
+void applyLut(const cv::Mat& input, cv::Mat& output, const utils::PointwiseLut& lut) {
+    if (input.empty()) { output.release(); return; }
     
-    cv::Mat output(gray.size(), CV_8UC1, cv::Scalar(0));
-    
-    #pragma omp parallel for collapse(2)
-    for (int i = 1; i < gray.rows - 1; i++) {
-        for (int j = 1; j < gray.cols - 1; j++) {
-            double angle = direction.at<double>(i, j) * 180.0 / CV_PI;
-            if (angle < 0) angle += 180;
-            
-            uchar mag = magnitude.at<uchar>(i, j);
-            uchar q = 255, r = 255;
-            
-            if ((angle >= 0 && angle < 22.5) || (angle >= 157.5 && angle <= 180)) {
-                q = magnitude.at<uchar>(i, j + 1);
-                r = magnitude.at<uchar>(i, j - 1);
-            } else if (angle >= 22.5 && angle < 67.5) {
-                q = magnitude.at<uchar>(i + 1, j - 1);
-                r = magnitude.at<uchar>(i - 1, j + 1);
-            } else if (angle >= 67.5 && angle < 112.5) {
-                q = magnitude.at<uchar>(i + 1, j);
-                r = magnitude.at<uchar>(i - 1, j);
-            } else if (angle >= 112.5 && angle < 157.5) {
-                q = magnitude.at<uchar>(i - 1, j - 1);
-                r = magnitude.at<uchar>(i + 1, j + 1);
-            }
-            
-            if (mag >= q && mag >= r) {
-                if (mag >= threshold2) {
-                    output.at<uchar>(i, j) = 255;
-                } else if (mag >= threshold1) {
-                    output.at<uchar>(i, j) = 128;
-                }
-            }
-        }
-    }
+    output.create(input.size(), input.type());
     
-    // Hysteresis (sequential part for correctness)
-    for (int i = 1; i < gray.rows - 1; i++) {
-        for (int j = 1; j < gray.cols - 1; j++) {
-            if (output.at<uchar>(i, j) == 128) {
-                bool hasStrongNeighbor = false;
-                for (int di = -1; di <= 1 && !hasStrongNeighbor; di++) {
-                    for (int dj = -1; dj <= 1 && !hasStrongNeighbor; dj++) {
-                        if (output.at<uchar>(i + di, j + dj) == 255) {
-                            hasStrongNeighbor = true;
-                        }
-                    }
-                }
-                output.at<uchar>(i, j) = hasStrongNeighbor ? 255 : 0;
-            }
-        }
+    #pragma omp parallel for
+    for (int i = 0; i < output.rows; i++) {
+        utils::applyLutRows(input, output, lut, i, i + 1);
     }
+}
+
+void median(const cv::Mat& input, cv::Mat& output, int kernelSize) {
+    if (input.empty()) { output.release(); return; }
+    
+    int k = kernelSize / 2;
+    output.create(input.size(), input.type());
+    forEachTile(input, output, k, k, [&](const cv::Mat& src, cv::Mat& dst) {
+        utils::medianRows(src, dst, kernelSize, 0, dst.rows);
+    });
+}
+
+void bilateral(const cv::Mat& input, cv::Mat& output, int d, double sigmaColor, double sigmaSpace, Precision precision) {
+    if (input.empty()) { output.release(); return; }
     
+    int radius = d / 2;
+    
+    // Pré-calcular pesos espaciais e tabela de pesos de cor
+    utils::BilateralWeights weights = utils::makeBilateralWeights(d, sigmaColor, sigmaSpace, precision);
+    
+    output.create(input.size(), input.type());
+    forEachTile(input, output, radius, radius, [&](const cv::Mat& src, cv::Mat& dst) {
+        utils::bilateralRows(src, dst, weights, 0, dst.rows);
+    });
+}
+
+// Versões que devolvem uma imagem nova
+
+cv::Mat grayscale(const cv::Mat& input, Precision precision) {
+    cv::Mat output;
+    grayscale(input, output, precision);
+    return output;
+}
+
+cv::Mat blur(const cv::Mat& input, int kernelSize, Precision precision) {
+    cv::Mat output;
+    blur(input, output, kernelSize, precision);
+    return output;
+}
+
+cv::Mat boxBlur(const cv::Mat& input, int kernelSize) {
+    cv::Mat output;
+    boxBlur(input, output, kernelSize);
+    return output;
+}
+
+cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize, Precision precision) {
+    cv::Mat output;
+    gaussianBlur(input, output, kernelSize, precision);
+    return output;
+}
+
+cv::Mat recursiveGaussianBlur(const cv::Mat& input, double sigma) {
+    cv::Mat output;
+    recursiveGaussianBlur(input, output, sigma);
+    return output;
+}
+
+cv::Mat sobel(const cv::Mat& input, GradientNorm norm) {
+    cv::Mat output;
+    sobel(input, output, norm);
+    return output;
+}
+
+cv::Mat canny(const cv::Mat& input, double threshold1, double threshold2) {
+    cv::Mat output;
+    canny(input, output, threshold1, threshold2);
     return output;
 }
 
 cv::Mat sharpen(const cv::Mat& input) {
-    if (input.empty()) return cv::Mat();
-    
-    cv::Mat kernel = utils::getSharpenKernel();
     cv::Mat output;
-    applyConvolutionParallel(input, output, kernel);
+    sharpen(input, output);
     return output;
 }
 
 cv::Mat emboss(const cv::Mat& input) {
-    if (input.empty()) return cv::Mat();
-    
-    cv::Mat kernel = utils::getEmbossKernel();
     cv::Mat output;
-    applyConvolutionParallel(input, output, kernel);
-    
-    #pragma omp parallel for collapse(2)
-    for (int i = 0; i < output.rows; i++) {
-        for (int j = 0; j < output.cols; j++) {
-            if (output.channels() == 1) {
-                output.at<uchar>(i, j) = cv::saturate_cast<uchar>(output.at<uchar>(i, j) + 128);
-            } else {
-                cv::Vec3b& pixel = output.at<cv::Vec3b>(i, j);
-                pixel[0] = cv::saturate_cast<uchar>(pixel[0] + 128);
-                pixel[1] = cv::saturate_cast<uchar>(pixel[1] + 128);
-                pixel[2] = cv::saturate_cast<uchar>(pixel[2] + 128);
-            }
-        }
-    }
-    
+    emboss(input, output);
     return output;
 }
 
 cv::Mat negative(const cv::Mat& input) {
-    if (input.empty()) return cv::Mat();
-    
-    cv::Mat output = input.clone();
-    
-    #pragma omp parallel for collapse(2)
-    for (int i = 0; i < input.rows; i++) {
-        for (int j = 0; j < input.cols; j++) {
-            if (input.channels() == 1) {
-                output.at<uchar>(i, j) = 255 - input.at<uchar>(i, j);
-            } else {
-                cv::Vec3b pixel = input.at<cv::Vec3b>(i, j);
-                output.at<cv::Vec3b>(i, j) = cv::Vec3b(255 - pixel[0], 255 - pixel[1], 255 - pixel[2]);
-            }
-        }
-    }
-    
+    cv::Mat output;
+    negative(input, output);
     return output;
 }
 
-cv::Mat sepia(const cv::Mat& input) {
-    if (input.empty()) return cv::Mat();
-    
-    cv::Mat colorInput = input.channels() == 1 ? utils::toColor(input) : input.clone();
-    cv::Mat output = colorInput.clone();
-    
-    #pragma omp parallel for collapse(2)
-    for (int i = 0; i < colorInput.rows; i++) {
-        for (int j = 0; j < colorInput.cols; j++) {
-            cv::Vec3b pixel = colorInput.at<cv::Vec3b>(i, j);
-            int b = pixel[0], g = pixel[1], r = pixel[2];
-            
-            int newR = static_cast<int>(0.393 * r + 0.769 * g + 0.189 * b);
-            int newG = static_cast<int>(0.349 * r + 0.686 * g + 0.168 * b);
-            int newB = static_cast<int>(0.272 * r + 0.534 * g + 0.131 * b);
-            
-            output.at<cv::Vec3b>(i, j) = cv::Vec3b(
-                cv::saturate_cast<uchar>(newB),
-                cv::saturate_cast<uchar>(newG),
-                cv::saturate_cast<uchar>(newR)
-            );
-        }
-    }
-    
+cv::Mat sepia(const cv::Mat& input, Precision precision) {
+    cv::Mat output;
+    sepia(input, output, precision);
     return output;
 }
 
 cv::Mat threshold(const cv::Mat& input, int thresholdValue) {
-    if (input.empty()) return cv::Mat();
-    
-    cv::Mat gray = input.channels() == 3 ? grayscale(input) : input.clone();
-    cv::Mat output(gray.size(), CV_8UC1);
-    
-    #pragma omp parallel for collapse(2)
-    for (int i = 0; i < gray.rows; i++) {
-        for (int j = 0; j < gray.cols; j++) {
-            output.at<uchar>(i, j) = gray.at<uchar>(i, j) > thresholdValue ? 255 : 0;
-        }
-    }
-    
+    cv::Mat output;
+    threshold(input, output, thresholdValue);
     return output;
 }
 
 cv::Mat median(const cv::Mat& input, int kernelSize) {
-    if (input.empty()) return cv::Mat();
-    
-    int k = kernelSize / 2;
-    cv::Mat padded;
-    cv::copyMakeBorder(input, padded, k, k, k, k, cv::BORDER_REPLICATE);
-    
-    cv::Mat output = cv::Mat::zeros(input.size(), input.type());
-    
-    #pragma omp parallel for collapse(2)
-    for (int i = 0; i < input.rows; i++) {
-        for (int j = 0; j < input.cols; j++) {
-            std::vector<uchar> values(kernelSize * kernelSize);
-            
-            if (input.channels() == 1) {
-                int idx = 0;
-                for (int ki = 0; ki < kernelSize; ki++) {
-                    for (int kj = 0; kj < kernelSize; kj++) {
-                        values[idx++] = padded.at<uchar>(i + ki, j + kj);
-                    }
-                }
-                std::sort(values.begin(), values.begin() + idx);
-                output.at<uchar>(i, j) = values[idx / 2];
-            } else {
-                std::vector<uchar> bValues(kernelSize * kernelSize);
-                std::vector<uchar> gValues(kernelSize * kernelSize);
-                std::vector<uchar> rValues(kernelSize * kernelSize);
-                int idx = 0;
-                for (int ki = 0; ki < kernelSize; ki++) {
-                    for (int kj = 0; kj < kernelSize; kj++) {
-                        cv::Vec3b pixel = padded.at<cv::Vec3b>(i + ki, j + kj);
-                        bValues[idx] = pixel[0];
-                        gValues[idx] = pixel[1];
-                        rValues[idx] = pixel[2];
-                        idx++;
-                    }
-                }
-                std::sort(bValues.begin(), bValues.begin() + idx);
-                std::sort(gValues.begin(), gValues.begin() + idx);
-                std::sort(rValues.begin(), rValues.begin() + idx);
-                output.at<cv::Vec3b>(i, j) = cv::Vec3b(bValues[idx / 2], gValues[idx / 2], rValues[idx / 2]);
-            }
-        }
-    }
-    
+    cv::Mat output;
+    median(input, output, kernelSize);
     return output;
 }
 
-cv::Mat bilateral(const cv::Mat& input, int d, double sigmaColor, double sigmaSpace) {
-    if (input.empty()) return cv::Mat();
-    
-    int radius = d / 2;
-    cv::Mat padded;
-    cv::copyMakeBorder(input, padded, radius, radius, radius, radius, cv::BORDER_REPLICATE);
-    
-    cv::Mat output = cv::Mat::zeros(input.size(), input.type());
-    
-    // Pré-calcular pesos espaciais
-    std::vector<std::vector<double>> spatialWeights(d, std::vector<double>(d));
-    for (int i = 0; i < d; i++) {
-        for (int j = 0; j < d; j++) {
-            int dx = i - radius;
-            int dy = j - radius;
-            spatialWeights[i][j] = std::exp(-(dx * dx + dy * dy) / (2 * sigmaSpace * sigmaSpace));
-        }
-    }
-    
-    #pragma omp parallel for collapse(2)
-    for (int i = 0; i < input.rows; i++) {
-        for (int j = 0; j < input.cols; j++) {
-            if (input.channels() == 1) {
-                double sumWeight = 0.0;
-                double sumValue = 0.0;
-                uchar centerVal = padded.at<uchar>(i + radius, j + radius);
-                
-                for (int ki = 0; ki < d; ki++) {
-                    for (int kj = 0; kj < d; kj++) {
-                        uchar neighVal = padded.at<uchar>(i + ki, j + kj);
-                        double colorDiff = centerVal - neighVal;
-                        double colorWeight = std::exp(-(colorDiff * colorDiff) / (2 * sigmaColor * sigmaColor));
-                        double weight = spatialWeights[ki][kj] * colorWeight;
-                        
-                        sumWeight += weight;
-                        sumValue += weight * neighVal;
-                    }
-                }
-                
-                output.at<uchar>(i, j) = cv::saturate_cast<uchar>(sumValue / sumWeight);
-            } else {
-                double sumWeightB = 0.0, sumWeightG = 0.0, sumWeightR = 0.0;
-                double sumB = 0.0, sumG = 0.0, sumR = 0.0;
-                cv::Vec3b centerPixel = padded.at<cv::Vec3b>(i + radius, j + radius);
-                
-                for (int ki = 0; ki < d; ki++) {
-                    for (int kj = 0; kj < d; kj++) {
-                        cv::Vec3b neighPixel = padded.at<cv::Vec3b>(i + ki, j + kj);
-                        
-                        for (int c = 0; c < 3; c++) {
-                            double colorDiff = centerPixel[c] - neighPixel[c];
-                            double colorWeight = std::exp(-(colorDiff * colorDiff) / (2 * sigmaColor * sigmaColor));
-                            double weight = spatialWeights[ki][kj] * colorWeight;
-                            
-                            if (c == 0) { sumWeightB += weight; sumB += weight * neighPixel[0]; }
-                            else if (c == 1) { sumWeightG += weight; sumG += weight * neighPixel[1]; }
-                            else { sumWeightR += weight; sumR += weight * neighPixel[2]; }
-                        }
-                    }
-                }
-                
-                output.at<cv::Vec3b>(i, j) = cv::Vec3b(
-                    cv::saturate_cast<uchar>(sumB / sumWeightB),
-                    cv::saturate_cast<uchar>(sumG / sumWeightG),
-                    cv::saturate_cast<uchar>(sumR / sumWeightR)
-                );
-            }
-        }
-    }
-    
+cv::Mat bilateral(const cv::Mat& input, int d, double sigmaColor, double sigmaSpace, Precision precision) {
+    cv::Mat output;
+    bilateral(input, output, d, sigmaColor, sigmaSpace, precision);
+    return output;
+}
+
+cv::Mat applyLut(const cv::Mat& input, const utils::PointwiseLut& lut) {
+    cv::Mat output;
+    applyLut(input, output, lut);
+    return output;
+}
+
+cv::Mat applyColorMatrix(const cv::Mat& input, const utils::ColorMatrix& matrix,
+                         const utils::PointwiseLut* lut, Precision precision) {
+    cv::Mat output;
+    applyColorMatrix(input, output, matrix, lut, precision);
     return output;
 }
 
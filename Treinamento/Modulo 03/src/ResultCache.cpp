@@ -0,0 +1,139 @@
+/**
+ * PAVIC LAB 2025 - ResultCache
+ * Cache LRU de resultados de filtros com orçamento de memória
+ */
+
+#include "ResultCache.h"
+#include <cstring>
+
+namespace pavic {
+
+// Constantes e rodada do xxHash64
+static const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+static const uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t mixRound(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    return rotl(acc, 31) * kPrime1;
+}
+
+static inline uint64_t readWord(const uchar* p) {
+    uint64_t w;
+    std::memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+ResultCache::ResultCache(size_t budgetBytes) : budget(budgetBytes) {}
+
+void ResultCache::setBudget(size_t bytes) {
+    budget = bytes;
+    evictUntil(budget);
+}
+
+bool ResultCache::lookup(uint64_t key, cv::Mat& image) {
+    auto it = index.find(key);
+    if (it == index.end()) {
+        misses++;
+        return false;
+    }
+    entries.splice(entries.begin(), entries, it->second);
+    image = it->second->image;
+    hits++;
+    return true;
+}
+
+void ResultCache::insert(uint64_t key, const cv::Mat& image) {
+    size_t size = image.total() * image.elemSize();
+    if (image.empty() || size > budget) return;
+
+    auto it = index.find(key);
+    if (it != index.end()) {
+        bytes -= it->second->bytes;
+        entries.erase(it->second);
+        index.erase(it);
+    }
+    evictUntil(budget - size);
+    entries.push_front(Entry{key, image, size});
+    index[key] = entries.begin();
+    bytes += size;
+}
+
+void ResultCache::clear() {
+    entries.clear();
+    index.clear();
+    bytes = 0;
+}
+
+void ResultCache::evictUntil(size_t limit) {
+    while (bytes > limit && !entries.empty()) {
+        bytes -= entries.back().bytes;
+        index.erase(entries.back().key);
+        entries.pop_back();
+        evictions++;
+    }
+}
+
+ResultCacheStats ResultCache::getStats() const {
+    ResultCacheStats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    stats.evictions = evictions;
+    stats.entries = entries.size();
+    stats.bytes = bytes;
+    stats.budgetBytes = budget;
+    return stats;
+}
+
+uint64_t ResultCache::combine(uint64_t seed, uint64_t value) {
+    return rotl(seed ^ mixRound(0, value), 27) * kPrime1 + kPrime4;
+}
+
+uint64_t ResultCache::hashImage(const cv::Mat& image) {
+    uint64_t v1 = kPrime1 + kPrime2;
+    uint64_t v2 = kPrime2;
+    uint64_t v3 = 0;
+    uint64_t v4 = 0 - kPrime1;
+    uint64_t tail = kPrime5;
+
+    // Linha a linha: uma ROI e uma cópia contínua com os mesmos pixels têm o mesmo hash
+    const size_t rowBytes = image.cols * image.elemSize();
+    for (int i = 0; i < image.rows; i++) {
+        const uchar* p = image.ptr<uchar>(i);
+        size_t j = 0;
+        for (; j + 32 <= rowBytes; j += 32) {
+            v1 = mixRound(v1, readWord(p + j));
+            v2 = mixRound(v2, readWord(p + j + 8));
+            v3 = mixRound(v3, readWord(p + j + 16));
+            v4 = mixRound(v4, readWord(p + j + 24));
+        }
+        for (; j + 8 <= rowBytes; j += 8) {
+            tail = rotl(tail ^ mixRound(0, readWord(p + j)), 27) * kPrime1 + kPrime4;
+        }
+        for (; j < rowBytes; j++) {
+            tail = rotl(tail ^ (p[j] * kPrime5), 11) * kPrime1;
+        }
+    }
+
+    uint64_t h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+    h = combine(h, tail);
+    h = combine(h, static_cast<uint64_t>(image.rows));
+    h = combine(h, static_cast<uint64_t>(image.cols));
+    h = combine(h, static_cast<uint64_t>(image.type()));
+
+    // Avalanche final
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+} // namespace pavic
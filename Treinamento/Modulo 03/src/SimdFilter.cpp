@@ -0,0 +1,633 @@
+/**
+ * PAVIC LAB 2025 - SIMD Filter Implementation
+ * Filtros vetorizados com intrínsecos SSE4.1/AVX2.
+ *
+ * As imagens são tratadas como linhas de bytes (BGR intercalado): o vizinho horizontal
+ * de um byte está a "cn" bytes de distância, então os mesmos kernels servem para imagens
+ * de 1 e 3 canais sem ramificação por canal. Conversões de cor usam ponto fixo Q14.
+ *
+ * Este arquivo é compilado sem flags de conjunto de instruções: prepara as imagens, divide as
+ * linhas entre threads e completa as sobras em escalar; os intrínsecos ficam em SimdKernels.cpp.
+ * Se a CPU não tiver o conjunto com que os núcleos foram compilados, os filtros recaem no
+ * backend multithread.
+ */
+
+#include "SimdFilter.h"
+#include "SimdKernels.h"
+#include "MultithreadFilter.h"
+#include "FilterUtils.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+// Definidos pelo build junto com as flags de SimdKernels.cpp (CMakeLists.txt / .vcxproj)
+#if defined(PAVIC_SIMD_AVX2) || defined(PAVIC_SIMD_SSE41)
+#define PAVIC_SIMD_ENABLED 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+namespace pavic {
+namespace simd {
+
+// Sem núcleos vetoriais (build ou CPU sem o conjunto de instruções): SAD escalar
+static uint64_t scalarSumAbsDiff(const cv::Mat& a, const cv::Mat& b, const cv::Rect& region, uint64_t limit) {
+    const size_t offset = region.x * a.elemSize();
+    const size_t rowBytes = region.width * a.elemSize();
+    uint64_t sad = 0;
+    for (int i = region.y; i < region.y + region.height && sad <= limit; i++) {
+        const uchar* pa = a.ptr<uchar>(i) + offset;
+        const uchar* pb = b.ptr<uchar>(i) + offset;
+        for (size_t j = 0; j < rowBytes; j++) sad += std::abs(pa[j] - pb[j]);
+    }
+    return sad;
+}
+
+#if defined(PAVIC_SIMD_ENABLED)
+
+// A CPU executa o conjunto de instruções dos núcleos? AVX2 exige também que o sistema
+// salve os registradores YMM (OSXSAVE + XCR0), o que __builtin_cpu_supports já confere.
+static bool detectKernelSupport() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+#if defined(PAVIC_SIMD_AVX2)
+    const bool osxsave = (info[2] & (1 << 27)) != 0, avx = (info[2] & (1 << 28)) != 0;
+    if (!sse41 || !osxsave || !avx || maxLeaf < 7 || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    (void)maxLeaf;
+    return sse41;
+#endif
+#elif defined(PAVIC_SIMD_AVX2)
+    return __builtin_cpu_supports("avx2");
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+static bool kernelsSupported() {
+    static const bool supported = detectKernelSupport();
+    return supported;
+}
+
+#endif // PAVIC_SIMD_ENABLED
+
+std::string getInstructionSet() {
+#if defined(PAVIC_SIMD_AVX2)
+    if (kernelsSupported()) return "AVX2";
+#elif defined(PAVIC_SIMD_SSE41)
+    if (kernelsSupported()) return "SSE4.1";
+#endif
+    return "Scalar";
+}
+
+bool isSIMDAvailable() {
+#if defined(PAVIC_SIMD_ENABLED)
+    return kernelsSupported();
+#else
+    return false;
+#endif
+}
+
+#if defined(PAVIC_SIMD_ENABLED)
+
+// numThreads == 1: executa na thread atual; caso contrário divide as linhas de image entre as threads
+// do pool, com faixas de pelo menos multithread::kMinTaskBytes
+static void forRows(const cv::Mat& image, int numThreads, const std::function<void(int,int)>& worker) {
+    if (numThreads == 1) {
+        worker(0, image.rows);
+        return;
+    }
+    multithread::runInThreads(image.rows, numThreads, worker, multithread::grainSize(image.cols * image.elemSize()));
+}
+
+// Mesmos coeficientes Q14 de Precision::FIXED_POINT: resultado idêntico aos backends escalares nesse modo
+static const int kColorShift = utils::kFixedShift;
+
+// Matriz de cor (utils::ColorMatrix) sobre BGR intercalado, 16 pixels por iteração. lut, ou o limiar
+// threshold em [0, 254] quando lut é a tabela de limiar, é aplicada ao resultado ainda em registrador,
+// de modo que cinza + limiar, por exemplo, é uma passada sem imagem intermediária.
+static void colorMatrixKernel(const cv::Mat& color, cv::Mat& output, const utils::ColorMatrix& matrix,
+                              const utils::PointwiseLut* lut, int threshold, int numThreads) {
+    const int out = matrix.outChannels;
+    const auto& w = matrix.fixed;
+
+    // _mm_madd_epi16 exige pesos em int16 (|coeficiente| < 2)
+    bool fits = true;
+    for (int c = 0; c < out; c++)
+        for (int k = 0; k < 3; k++) fits = fits && w[c][k] >= -32768 && w[c][k] <= 32767;
+    if (!fits) {
+        forRows(color, numThreads, [&](int s, int e) {
+            utils::colorMatrixRows(color, output, matrix, s, e, Precision::FIXED_POINT, lut);
+        });
+        return;
+    }
+
+    forRows(color, numThreads, [&](int s, int e) {
+        for (int i = s; i < e; i++) {
+            const uchar* src = color.ptr<uchar>(i);
+            uchar* dst = output.ptr<uchar>(i);
+            int j = kernels::colorMatrixRow(src, dst, color.cols, w, out, kColorShift, lut ? lut->table : nullptr, threshold);
+            for (; j < color.cols; j++) {
+                const int b = src[j * 3], g = src[j * 3 + 1], r = src[j * 3 + 2];  // antes de gravar: in-place
+                for (int c = 0; c < out; c++) {
+                    uchar v = cv::saturate_cast<uchar>((r * w[c][0] + g * w[c][1] + b * w[c][2]) >> kColorShift);
+                    dst[j * out + c] = lut ? lut->table[v] : v;
+                }
+            }
+        }
+    });
+}
+
+// ============== Convolução ==============
+
+// Convolução 2D: percorre apenas os taps não nulos do kernel
+static void convolve(const cv::Mat& input, cv::Mat& output, const cv::Mat& kernel, int numThreads) {
+    int cy = kernel.rows / 2, cx = kernel.cols / 2;
+    int cn = input.channels();
+    int rowLen = input.cols * cn;
+
+    cv::Mat padded;
+    cv::copyMakeBorder(input, padded, cy, cy, cx, cx, cv::BORDER_REPLICATE);
+
+    std::vector<kernels::Tap> taps;
+    for (int ki = 0; ki < kernel.rows; ki++) {
+        for (int kj = 0; kj < kernel.cols; kj++) {
+            double w = kernel.at<double>(ki, kj);
+            if (w != 0.0) taps.push_back({ki, kj * cn, static_cast<float>(w)});
+        }
+    }
+    const int tapCount = static_cast<int>(taps.size());
+
+    output.create(input.size(), input.type());
+    forRows(input, numThreads, [&](int s, int e) {
+        std::vector<const uchar*> rows(kernel.rows);
+        for (int i = s; i < e; i++) {
+            for (int ki = 0; ki < kernel.rows; ki++) rows[ki] = padded.ptr<uchar>(i + ki);
+            uchar* dst = output.ptr<uchar>(i);
+            int j = kernels::convolveRow(rows.data(), taps.data(), tapCount, dst, rowLen);
+            for (; j < rowLen; j++) {
+                float acc = 0.0f;
+                for (const kernels::Tap& t : taps) acc += t.weight * rows[t.row][t.offset + j];
+                dst[j] = cv::saturate_cast<uchar>(acc);
+            }
+        }
+    });
+}
+
+// Convolução separável com o mesmo kernel 1D nos dois eixos. O passe horizontal já gera as
+// linhas de borda replicadas no buffer float, então o passe vertical não precisa de padding.
+static void convolveSeparable(const cv::Mat& input, cv::Mat& output, const std::vector<double>& kernel, int numThreads) {
+    int k = static_cast<int>(kernel.size()), r = k / 2;
+    int cn = input.channels();
+    int rowLen = input.cols * cn;
+    std::vector<float> w(kernel.begin(), kernel.end());
+
+    cv::Mat paddedX;
+    cv::copyMakeBorder(input, paddedX, 0, 0, r, r, cv::BORDER_REPLICATE);
+    cv::Mat temp(input.rows + 2 * r, input.cols, CV_32FC(cn));
+
+    forRows(temp, numThreads, [&](int s, int e) {
+        for (int t = s; t < e; t++) {
+            const uchar* src = paddedX.ptr<uchar>(std::min(std::max(t - r, 0), input.rows - 1));
+            float* dst = temp.ptr<float>(t);
+            int j = kernels::separableRowH(src, dst, rowLen, w.data(), k, cn);
+            for (; j < rowLen; j++) {
+                float acc = 0.0f;
+                for (int q = 0; q < k; q++) acc += w[q] * src[j + q * cn];
+                dst[j] = acc;
+            }
+        }
+    });
+
+    output.create(input.size(), input.type());
+    forRows(input, numThreads, [&](int s, int e) {
+        std::vector<const float*> rows(k);
+        for (int i = s; i < e; i++) {
+            for (int q = 0; q < k; q++) rows[q] = temp.ptr<float>(i + q);
+            uchar* dst = output.ptr<uchar>(i);
+            int j = kernels::separableRowV(rows.data(), dst, rowLen, w.data(), k);
+            for (; j < rowLen; j++) {
+                float acc = 0.0f;
+                for (int q = 0; q < k; q++) acc += w[q] * rows[q][j];
+                dst[j] = cv::saturate_cast<uchar>(acc);
+            }
+        }
+    });
+}
+
+// ============== Filtros ==============
+
+void grayscale(const cv::Mat& input, cv::Mat& output, int numThreads) {
+    if (!kernelsSupported()) { multithread::grayscale(input, output, numThreads); return; }
+    if (input.empty()) { output.release(); return; }
+    if (input.channels() == 1) { input.copyTo(output); return; }
+
+    static const utils::ColorMatrix gray = utils::makeGrayscaleMatrix();
+    cv::Mat src = input;  // output pode ser a própria entrada: create() troca o buffer dela
+    output.create(src.rows, src.cols, CV_8UC1);
+    colorMatrixKernel(src, output, gray, nullptr, -1, numThreads);
+}
+
+void blur(const cv::Mat& input, cv::Mat& output, int kernelSize, int numThreads) {
+    if (!kernelsSupported()) { multithread::blur(input, output, kernelSize, numThreads); return; }
+    if (input.empty()) { output.release(); return; }
+    convolveSeparable(input, output, utils::getBoxBlurKernel1D(kernelSize), numThreads);
+}
+
+void gaussianBlur(const cv::Mat& input, cv::Mat& output, int kernelSize, int numThreads) {
+    if (!kernelsSupported()) { multithread::gaussianBlur(input, output, kernelSize, numThreads); return; }
+    if (input.empty()) { output.release(); return; }
+    if (utils::useRecursiveGaussian(kernelSize)) {
+        multithread::recursiveGaussianBlur(input, output, utils::getGaussianSigma(kernelSize), numThreads);
+        return;
+    }
+    convolveSeparable(input, output, utils::getGaussianKernel1D(kernelSize), numThreads);
+}
+
+static kernels::Norm kernelNorm(GradientNorm norm) {
+    switch (norm) {
+        case GradientNorm::L1: return kernels::Norm::L1;
+        case GradientNorm::FAST: return kernels::Norm::FAST;
+        default: return kernels::Norm::L2;
+    }
+}
+
+// Sobel fundido: lê a vizinhança 3x3 uma vez e grava a magnitude na norma pedida. gx e gy são
+// inteiros exatos em float, então o resultado é o mesmo de utils::sobelRows.
+void sobel(const cv::Mat& input, cv::Mat& output, int numThreads, GradientNorm norm) {
+    if (!kernelsSupported()) { multithread::sobel(input, output, numThreads, norm); return; }
+    if (input.empty()) { output.release(); return; }
+
+    cv::Mat gray = input.channels() == 3 ? grayscale(input, numThreads) : input;
+    cv::Mat padded;
+    cv::copyMakeBorder(gray, padded, 1, 1, 1, 1, cv::BORDER_REPLICATE);
+    output.create(gray.size(), CV_8UC1);  // a vizinhança já está em padded: in-place seguro
+
+    forRows(gray, numThreads, [&](int s, int e) {
+        for (int i = s; i < e; i++) {
+            const uchar* p0 = padded.ptr<uchar>(i);
+            const uchar* p1 = padded.ptr<uchar>(i + 1);
+            const uchar* p2 = padded.ptr<uchar>(i + 2);
+            uchar* dst = output.ptr<uchar>(i);
+            int j = kernels::sobelRow(p0, p1, p2, dst, gray.cols, kernelNorm(norm));
+            for (; j < gray.cols; j++) {
+                int gx = (p0[j + 2] + 2 * p1[j + 2] + p2[j + 2]) - (p0[j] + 2 * p1[j] + p2[j]);
+                int gy = (p2[j] + 2 * p2[j + 1] + p2[j + 2]) - (p0[j] + 2 * p0[j + 1] + p0[j + 2]);
+                dst[j] = cv::saturate_cast<uchar>(utils::gradientMagnitude(gx, gy, norm));
+            }
+        }
+    });
+}
+
+void canny(const cv::Mat& input, cv::Mat& output, double threshold1, double threshold2, int numThreads) {
+    if (!kernelsSupported()) { multithread::canny(input, output, threshold1, threshold2, numThreads); return; }
+    if (input.empty()) { output.release(); return; }
+
+    cv::Mat gray = input.channels() == 3 ? grayscale(input, numThreads) : input;
+    cv::Mat blurred = gaussianBlur(gray, 5, numThreads);
+    cv::Mat padded;
+    cv::copyMakeBorder(blurred, padded, 1, 1, 1, 1, cv::BORDER_REPLICATE);
+
+    // Sobel e magnitude vetorizados (inteiros exatos em float); o setor da direção sai de
+    // comparações inteiras por pixel e é compactado com a magnitude (utils::packCannyGradient)
+    cv::Mat gradient(gray.size(), CV_16UC1);
+    forRows(gray, numThreads, [&](int s, int e) {
+        std::vector<int> gxRow(gray.cols), gyRow(gray.cols), magRow(gray.cols);
+        for (int i = s; i < e; i++) {
+            const uchar* p0 = padded.ptr<uchar>(i);
+            const uchar* p1 = padded.ptr<uchar>(i + 1);
+            const uchar* p2 = padded.ptr<uchar>(i + 2);
+            uint16_t* dst = gradient.ptr<uint16_t>(i);
+            int done = kernels::cannyGradientRow(p0, p1, p2, gray.cols, gxRow.data(), gyRow.data(), magRow.data());
+            for (int j = 0; j < done; j++) dst[j] = utils::packCannyGradient(magRow[j], gxRow[j], gyRow[j]);
+            for (int j = done; j < gray.cols; j++) {
+                int gx = (p0[j + 2] + 2 * p1[j + 2] + p2[j + 2]) - (p0[j] + 2 * p1[j] + p2[j]);
+                int gy = (p2[j] + 2 * p2[j + 1] + p2[j + 2]) - (p0[j] + 2 * p0[j + 1] + p0[j + 2]);
+                int magnitude = static_cast<int>(std::sqrt(static_cast<float>(gx * gx + gy * gy)));
+                dst[j] = utils::packCannyGradient(magnitude, gx, gy);
+            }
+        }
+    });
+
+    output.create(gray.size(), CV_8UC1);
+    forRows(gray, numThreads, [&](int s, int e) { utils::cannyNmsRows(gradient, output, threshold1, threshold2, s, e); });
+
+    // Histerese: union-find por faixa, fronteiras (início de cada faixa) unidas em série
+    std::vector<int> labels(output.total());
+    std::vector<char> bandStart(gray.rows, 0);
+    forRows(gray, numThreads, [&](int s, int e) {
+        bandStart[s] = 1;
+        utils::hysteresisLabelRows(output, labels, s, e);
+    });
+    for (int i = 1; i < gray.rows; i++) {
+        if (bandStart[i]) utils::hysteresisMergeRow(labels, output.cols, i);
+    }
+    forRows(gray, numThreads, [&](int s, int e) { utils::hysteresisResolveRows(output, labels, s, e); });
+}
+
+void sharpen(const cv::Mat& input, cv::Mat& output, int numThreads) {
+    if (!kernelsSupported()) { multithread::sharpen(input, output, numThreads); return; }
+    if (input.empty()) { output.release(); return; }
+    convolve(input, output, utils::getSharpenKernel(), numThreads);
+}
+
+void emboss(const cv::Mat& input, cv::Mat& output, int numThreads) {
+    if (!kernelsSupported()) { multithread::emboss(input, output, numThreads); return; }
+    if (input.empty()) { output.release(); return; }
+    convolve(input, output, utils::getEmbossKernel(), numThreads);
+
+    // +128 com saturação, 32/16 bytes por instrução
+    int rowLen = output.cols * output.channels();
+    forRows(output, numThreads, [&](int s, int e) {
+        for (int i = s; i < e; i++) {
+            uchar* row = output.ptr<uchar>(i);
+            int j = kernels::addSaturateRow(row, rowLen, 128);
+            for (; j < rowLen; j++) row[j] = cv::saturate_cast<uchar>(row[j] + 128);
+        }
+    });
+}
+
+void negative(const cv::Mat& input, cv::Mat& output, int numThreads) {
+    if (!kernelsSupported()) { multithread::negative(input, output, numThreads); return; }
+    if (input.empty()) { output.release(); return; }
+    output.create(input.size(), input.type());  // pontual: cada vetor é lido antes de gravado
+    int rowLen = input.cols * input.channels();
+    forRows(input, numThreads, [&](int s, int e) {
+        for (int i = s; i < e; i++) {
+            const uchar* src = input.ptr<uchar>(i);
+            uchar* dst = output.ptr<uchar>(i);
+            int j = kernels::invertRow(src, dst, rowLen);
+            for (; j < rowLen; j++) dst[j] = 255 - src[j];
+        }
+    });
+}
+
+void sepia(const cv::Mat& input, cv::Mat& output, int numThreads) {
+    if (!kernelsSupported()) { multithread::sepia(input, output, numThreads); return; }
+    if (input.empty()) { output.release(); return; }
+
+    static const utils::ColorMatrix sepiaMatrix = utils::makeSepiaMatrix();
+    cv::Mat color = input.channels() == 1 ? utils::toColor(input) : input;
+    output.create(color.size(), CV_8UC3);
+    colorMatrixKernel(color, output, sepiaMatrix, nullptr, -1, numThreads);
+}
+
+void threshold(const cv::Mat& input, cv::Mat& output, int thresholdValue, int numThreads) {
+    if (!kernelsSupported()) { multithread::threshold(input, output, thresholdValue, numThreads); return; }
+    if (input.empty()) { output.release(); return; }
+
+    if (input.channels() == 3) {
+        // Cinza e limiar na mesma passada: a imagem cinza intermediária não é gravada
+        static const utils::ColorMatrix grayMatrix = utils::makeGrayscaleMatrix();
+        utils::PointwiseLut lut = utils::makeThresholdLut(thresholdValue);
+        cv::Mat color = input;  // output pode ser a própria entrada: create() troca o buffer dela
+        output.create(color.size(), CV_8UC1);
+        colorMatrixKernel(color, output, grayMatrix, &lut, thresholdValue, numThreads);
+        return;
+    }
+
+    const cv::Mat gray = input;
+    output.create(gray.size(), CV_8UC1);
+    if (thresholdValue < 0 || thresholdValue >= 255) {
+        output.setTo(cv::Scalar(thresholdValue < 0 ? 255 : 0));
+        return;
+    }
+
+    forRows(gray, numThreads, [&](int s, int e) {
+        for (int i = s; i < e; i++) {
+            const uchar* src = gray.ptr<uchar>(i);
+            uchar* dst = output.ptr<uchar>(i);
+            int j = kernels::thresholdRow(src, dst, gray.cols, thresholdValue);
+            for (; j < gray.cols; j++) dst[j] = src[j] > thresholdValue ? 255 : 0;
+        }
+    });
+}
+
+void applyColorMatrix(const cv::Mat& input, cv::Mat& output, const utils::ColorMatrix& matrix,
+                      const utils::PointwiseLut* lut, int numThreads) {
+    if (!kernelsSupported()) { multithread::applyColorMatrix(input, output, matrix, lut, numThreads); return; }
+    if (input.empty()) { output.release(); return; }
+    cv::Mat color = input.channels() == 1 ? utils::toColor(input) : input;
+    output.create(color.size(), CV_8UC(matrix.outChannels));
+    colorMatrixKernel(color, output, matrix, lut, -1, numThreads);
+}
+
+void applyLut(const cv::Mat& input, cv::Mat& output, const utils::PointwiseLut& lut, int numThreads) {
+    if (!kernelsSupported()) { multithread::applyLut(input, output, lut, numThreads); return; }
+    if (input.empty()) { output.release(); return; }
+    output.create(input.size(), input.type());
+#if defined(PAVIC_SIMD_AVX2)
+    // vpgatherdd: 8 consultas por instrução numa cópia da tabela em int32
+    alignas(32) int table[256];
+    for (int v = 0; v < 256; v++) table[v] = lut.table[v];
+    int rowLen = input.cols * input.channels();
+    forRows(input, numThreads, [&](int s, int e) {
+        for (int i = s; i < e; i++) {
+            const uchar* src = input.ptr<uchar>(i);
+            uchar* dst = output.ptr<uchar>(i);
+            int j = kernels::lutRow(src, dst, rowLen, table);
+            for (; j < rowLen; j++) dst[j] = lut.table[src[j]];
+        }
+    });
+#else
+    // Sem gather em SSE4.1: a consulta escalar desenrolada já é limitada pela memória
+    forRows(input, numThreads, [&](int s, int e) { utils::applyLutRows(input, output, lut, s, e); });
+#endif
+}
+
+// Mediana: a rede de seleção de utils::medianRows (3x3 e 5x5: colunas pré-ordenadas e comparações
+// SSE2 de 16 bytes) ou o histograma deslizante (demais K), por tiles com borda virtual
+void median(const cv::Mat& input, cv::Mat& output, int kernelSize, int numThreads) {
+    multithread::median(input, output, kernelSize, numThreads);
+}
+
+// Bilateral por canal (como nos outros backends), com peso de cor tabelado e lido por gather
+void bilateral(const cv::Mat& input, cv::Mat& output, int d, double sigmaColor, double sigmaSpace, int numThreads) {
+    if (!kernelsSupported()) { multithread::bilateral(input, output, d, sigmaColor, sigmaSpace, numThreads); return; }
+    if (input.empty()) { output.release(); return; }
+
+    int radius = d / 2;
+    int cn = input.channels();
+    int rowLen = input.cols * cn;
+    cv::Mat padded;
+    cv::copyMakeBorder(input, padded, radius, radius, radius, radius, cv::BORDER_REPLICATE);
+    output.create(input.size(), input.type());
+
+    std::vector<kernels::Tap> taps;
+    for (int i = 0; i < d; i++) {
+        for (int j = 0; j < d; j++) {
+            int dx = i - radius, dy = j - radius;
+            taps.push_back({i, j * cn, static_cast<float>(std::exp(-(dx * dx + dy * dy) / (2 * sigmaSpace * sigmaSpace)))});
+        }
+    }
+    const int tapCount = static_cast<int>(taps.size());
+    std::vector<float> colorLut(256);
+    for (int diff = 0; diff < 256; diff++) {
+        colorLut[diff] = static_cast<float>(std::exp(-(diff * diff) / (2 * sigmaColor * sigmaColor)));
+    }
+
+    forRows(input, numThreads, [&](int s, int e) {
+        std::vector<const uchar*> rows(d);
+        for (int i = s; i < e; i++) {
+            for (int ki = 0; ki < d; ki++) rows[ki] = padded.ptr<uchar>(i + ki);
+            const uchar* center = rows[radius] + radius * cn;
+            uchar* dst = output.ptr<uchar>(i);
+            int j = kernels::bilateralRow(rows.data(), center, taps.data(), tapCount, colorLut.data(), dst, rowLen);
+            for (; j < rowLen; j++) {
+                float sumW = 0.0f, sumV = 0.0f;
+                for (const kernels::Tap& t : taps) {
+                    uchar nb = rows[t.row][t.offset + j];
+                    float w = t.weight * colorLut[std::abs(center[j] - nb)];
+                    sumW += w;
+                    sumV += w * nb;
+                }
+                dst[j] = cv::saturate_cast<uchar>(sumV / sumW);
+            }
+        }
+    });
+}
+
+// Versões que devolvem uma imagem nova
+
+cv::Mat grayscale(const cv::Mat& input, int numThreads) {
+    cv::Mat output;
+    grayscale(input, output, numThreads);
+    return output;
+}
+
+cv::Mat blur(const cv::Mat& input, int kernelSize, int numThreads) {
+    cv::Mat output;
+    blur(input, output, kernelSize, numThreads);
+    return output;
+}
+
+cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize, int numThreads) {
+    cv::Mat output;
+    gaussianBlur(input, output, kernelSize, numThreads);
+    return output;
+}
+
+cv::Mat sobel(const cv::Mat& input, int numThreads, GradientNorm norm) {
+    cv::Mat output;
+    sobel(input, output, numThreads, norm);
+    return output;
+}
+
+cv::Mat canny(const cv::Mat& input, double threshold1, double threshold2, int numThreads) {
+    cv::Mat output;
+    canny(input, output, threshold1, threshold2, numThreads);
+    return output;
+}
+
+cv::Mat sharpen(const cv::Mat& input, int numThreads) {
+    cv::Mat output;
+    sharpen(input, output, numThreads);
+    return output;
+}
+
+cv::Mat emboss(const cv::Mat& input, int numThreads) {
+    cv::Mat output;
+    emboss(input, output, numThreads);
+    return output;
+}
+
+cv::Mat negative(const cv::Mat& input, int numThreads) {
+    cv::Mat output;
+    negative(input, output, numThreads);
+    return output;
+}
+
+cv::Mat sepia(const cv::Mat& input, int numThreads) {
+    cv::Mat output;
+    sepia(input, output, numThreads);
+    return output;
+}
+
+cv::Mat threshold(const cv::Mat& input, int thresholdValue, int numThreads) {
+    cv::Mat output;
+    threshold(input, output, thresholdValue, numThreads);
+    return output;
+}
+
+cv::Mat median(const cv::Mat& input, int kernelSize, int numThreads) {
+    cv::Mat output;
+    median(input, output, kernelSize, numThreads);
+    return output;
+}
+
+cv::Mat bilateral(const cv::Mat& input, int d, double sigmaColor, double sigmaSpace, int numThreads) {
+    cv::Mat output;
+    bilateral(input, output, d, sigmaColor, sigmaSpace, numThreads);
+    return output;
+}
+
+cv::Mat applyLut(const cv::Mat& input, const utils::PointwiseLut& lut, int numThreads) {
+    cv::Mat output;
+    applyLut(input, output, lut, numThreads);
+    return output;
+}
+
+cv::Mat applyColorMatrix(const cv::Mat& input, const utils::ColorMatrix& matrix,
+                         const utils::PointwiseLut* lut, int numThreads) {
+    cv::Mat output;
+    applyColorMatrix(input, output, matrix, lut, numThreads);
+    return output;
+}
+
+uint64_t sumAbsDiff(const cv::Mat& a, const cv::Mat& b, const cv::Rect& region, uint64_t limit) {
+    if (!kernelsSupported()) return scalarSumAbsDiff(a, b, region, limit);
+    const size_t offset = region.x * a.elemSize();
+    const size_t rowBytes = region.width * a.elemSize();
+    uint64_t sad = 0;
+    for (int i = region.y; i < region.y + region.height && sad <= limit; i++) {
+        sad += kernels::sumAbsDiffRow(a.ptr<uchar>(i) + offset, b.ptr<uchar>(i) + offset, rowBytes);
+    }
+    return sad;
+}
+
+#else // !PAVIC_SIMD_ENABLED
+
+// Build sem núcleos SSE4.1/AVX2: usa o backend multithread (numThreads = 1 -> uma thread)
+cv::Mat grayscale(const cv::Mat& input, int numThreads) { return multithread::grayscale(input, numThreads); }
+cv::Mat blur(const cv::Mat& input, int kernelSize, int numThreads) { return multithread::blur(input, kernelSize, numThreads); }
+cv::Mat gaussianBlur(const cv::Mat& input, int kernelSize, int numThreads) { return multithread::gaussianBlur(input, kernelSize, numThreads); }
+cv::Mat sobel(const cv::Mat& input, int numThreads, GradientNorm norm) { return multithread::sobel(input, numThreads, norm); }
+cv::Mat canny(const cv::Mat& input, double threshold1, double threshold2, int numThreads) { return multithread::canny(input, threshold1, threshold2, numThreads); }
+cv::Mat sharpen(const cv::Mat& input, int numThreads) { return multithread::sharpen(input, numThreads); }
+cv::Mat emboss(const cv::Mat& input, int numThreads) { return multithread::emboss(input, numThreads); }
+cv::Mat negative(const cv::Mat& input, int numThreads) { return multithread::negative(input, numThreads); }
+cv::Mat sepia(const cv::Mat& input, int numThreads) { return multithread::sepia(input, numThreads); }
+cv::Mat threshold(const cv::Mat& input, int thresholdValue, int numThreads) { return multithread::threshold(input, thresholdValue, numThreads); }
+cv::Mat applyLut(const cv::Mat& input, const utils::PointwiseLut& lut, int numThreads) { return multithread::applyLut(input, lut, numThreads); }
+cv::Mat applyColorMatrix(const cv::Mat& input, const utils::ColorMatrix& matrix, const utils::PointwiseLut* lut, int numThreads) { return multithread::applyColorMatrix(input, matrix, lut, numThreads); }
+cv::Mat median(const cv::Mat& input, int kernelSize, int numThreads) { return multithread::median(input, kernelSize, numThreads); }
+cv::Mat bilateral(const cv::Mat& input, int d, double sigmaColor, double sigmaSpace, int numThreads) { return multithread::bilateral(input, d, sigmaColor, sigmaSpace, numThreads); }
+void grayscale(const cv::Mat& input, cv::Mat& output, int numThreads) { multithread::grayscale(input, output, numThreads); }
+void blur(const cv::Mat& input, cv::Mat& output, int kernelSize, int numThreads) { multithread::blur(input, output, kernelSize, numThreads); }
+void gaussianBlur(const cv::Mat& input, cv::Mat& output, int kernelSize, int numThreads) { multithread::gaussianBlur(input, output, kernelSize, numThreads); }
+void sobel(const cv::Mat& input, cv::Mat& output, int numThreads, GradientNorm norm) { multithread::sobel(input, output, numThreads, norm); }
+void canny(const cv::Mat& input, cv::Mat& output, double threshold1, double threshold2, int numThreads) { multithread::canny(input, output, threshold1, threshold2, numThreads); }
+void sharpen(const cv::Mat& input, cv::Mat& output, int numThreads) { multithread::sharpen(input, output, numThreads); }
+void emboss(const cv::Mat& input, cv::Mat& output, int numThreads) { multithread::emboss(input, output, numThreads); }
+void negative(const cv::Mat& input, cv::Mat& output, int numThreads) { multithread::negative(input, output, numThreads); }
+void sepia(const cv::Mat& input, cv::Mat& output, int numThreads) { multithread::sepia(input, output, numThreads); }
+void threshold(const cv::Mat& input, cv::Mat& output, int thresholdValue, int numThreads) { multithread::threshold(input, output, thresholdValue, numThreads); }
+void applyLut(const cv::Mat& input, cv::Mat& output, const utils::PointwiseLut& lut, int numThreads) { multithread::applyLut(input, output, lut, numThreads); }
+void applyColorMatrix(const cv::Mat& input, cv::Mat& output, const utils::ColorMatrix& matrix, const utils::PointwiseLut* lut, int numThreads) { multithread::applyColorMatrix(input, output, matrix, lut, numThreads); }
+void median(const cv::Mat& input, cv::Mat& output, int kernelSize, int numThreads) { multithread::median(input, output, kernelSize, numThreads); }
+void bilateral(const cv::Mat& input, cv::Mat& output, int d, double sigmaColor, double sigmaSpace, int numThreads) { multithread::bilateral(input, output, d, sigmaColor, sigmaSpace, numThreads); }
+
+uint64_t sumAbsDiff(const cv::Mat& a, const cv::Mat& b, const cv::Rect& region, uint64_t limit) { return scalarSumAbsDiff(a, b, region, limit); }
+
+#endif // PAVIC_SIMD_ENABLED
+
+} // namespace simd
+} // namespace pavic
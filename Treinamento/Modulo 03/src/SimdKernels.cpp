@@ -0,0 +1,418 @@
+/**
+ * PAVIC LAB 2025 - SIMD Kernels
+ * Núcleos de linha com intrínsecos SSE4.1/AVX2 (único arquivo compilado com essas flags).
+ *
+ * Não inclui OpenCV nem cabeçalhos C++ da biblioteca padrão: ver SimdKernels.h.
+ */
+
+#include "SimdKernels.h"
+
+#if defined(PAVIC_SIMD_AVX2) || defined(PAVIC_SIMD_SSE41)
+#include <immintrin.h>
+
+// GCC/Clang só geram os intrínsecos com as flags do CMake; o MSVC aceita SSE4.1 sem /arch
+#if defined(PAVIC_SIMD_AVX2) && !defined(__AVX2__) && !defined(_MSC_VER)
+#error "PAVIC_SIMD_AVX2 exige compilar SimdKernels.cpp com -mavx2"
+#endif
+#if defined(PAVIC_SIMD_SSE41) && !defined(__SSE4_1__) && !defined(_MSC_VER)
+#error "PAVIC_SIMD_SSE41 exige compilar SimdKernels.cpp com -msse4.1"
+#endif
+
+namespace pavic {
+namespace simd {
+namespace kernels {
+
+// ============== Primitivas vetoriais ==============
+
+#if defined(PAVIC_SIMD_AVX2)
+typedef __m256i VecU8;   // 32 bytes
+typedef __m256i VecI;    // 8 x int32
+typedef __m256 VecF;     // 8 x float
+static const int kU8Lanes = 32;
+static const int kFLanes = 8;
+
+static inline VecU8 loadU8(const uint8_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+static inline void storeU8(uint8_t* p, VecU8 v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+static inline VecU8 setU8(int v) { return _mm256_set1_epi8(static_cast<char>(v)); }
+static inline VecU8 xorU8(VecU8 a, VecU8 b) { return _mm256_xor_si256(a, b); }
+static inline VecU8 addsU8(VecU8 a, VecU8 b) { return _mm256_adds_epu8(a, b); }
+static inline VecU8 subsU8(VecU8 a, VecU8 b) { return _mm256_subs_epu8(a, b); }
+static inline VecU8 cmpeqU8(VecU8 a, VecU8 b) { return _mm256_cmpeq_epi8(a, b); }
+
+static inline VecI loadU8AsI32(const uint8_t* p) {
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+static inline VecI absDiffI32(VecI a, VecI b) { return _mm256_abs_epi32(_mm256_sub_epi32(a, b)); }
+static inline VecF toF(VecI v) { return _mm256_cvtepi32_ps(v); }
+static inline VecF loadU8AsF(const uint8_t* p) { return toF(loadU8AsI32(p)); }
+static inline VecF loadF(const float* p) { return _mm256_loadu_ps(p); }
+static inline void storeF(float* p, VecF v) { _mm256_storeu_ps(p, v); }
+static inline VecF setF(float v) { return _mm256_set1_ps(v); }
+static inline VecF zeroF() { return _mm256_setzero_ps(); }
+static inline VecF addF(VecF a, VecF b) { return _mm256_add_ps(a, b); }
+static inline VecF subF(VecF a, VecF b) { return _mm256_sub_ps(a, b); }
+static inline VecF mulF(VecF a, VecF b) { return _mm256_mul_ps(a, b); }
+static inline VecF divF(VecF a, VecF b) { return _mm256_div_ps(a, b); }
+static inline VecF sqrtF(VecF a) { return _mm256_sqrt_ps(a); }
+static inline VecF minF(VecF a, VecF b) { return _mm256_min_ps(a, b); }
+static inline VecF maxF(VecF a, VecF b) { return _mm256_max_ps(a, b); }
+static inline VecF absF(VecF a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+static inline VecF gatherF(const float* table, VecI idx) { return _mm256_i32gather_ps(table, idx, 4); }
+
+static inline void packI32ToU8(uint8_t* p, VecI v) {
+    __m128i w = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(w, w));
+}
+static inline void storeFAsU8(uint8_t* p, VecF v) { packI32ToU8(p, _mm256_cvtps_epi32(v)); }
+static inline VecI truncFToI(VecF v) { return _mm256_cvttps_epi32(v); }
+static inline void storeI(int* p, VecI v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+static inline void storeFAsU8Trunc(uint8_t* p, VecF v) { packI32ToU8(p, _mm256_cvttps_epi32(v)); }
+#else
+typedef __m128i VecU8;   // 16 bytes
+typedef __m128i VecI;    // 4 x int32
+typedef __m128 VecF;     // 4 x float
+static const int kU8Lanes = 16;
+static const int kFLanes = 4;
+
+static inline VecU8 loadU8(const uint8_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+static inline void storeU8(uint8_t* p, VecU8 v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+static inline VecU8 setU8(int v) { return _mm_set1_epi8(static_cast<char>(v)); }
+static inline VecU8 xorU8(VecU8 a, VecU8 b) { return _mm_xor_si128(a, b); }
+static inline VecU8 addsU8(VecU8 a, VecU8 b) { return _mm_adds_epu8(a, b); }
+static inline VecU8 subsU8(VecU8 a, VecU8 b) { return _mm_subs_epu8(a, b); }
+static inline VecU8 cmpeqU8(VecU8 a, VecU8 b) { return _mm_cmpeq_epi8(a, b); }
+
+// 4 bytes sem memcpy (<cstring> fica de fora deste arquivo); o compilador junta em uma leitura
+static inline VecI loadU8AsI32(const uint8_t* p) {
+    uint32_t bytes = p[0] | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+                     (static_cast<uint32_t>(p[3]) << 24);
+    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(static_cast<int>(bytes)));
+}
+static inline VecI absDiffI32(VecI a, VecI b) { return _mm_abs_epi32(_mm_sub_epi32(a, b)); }
+static inline VecF toF(VecI v) { return _mm_cvtepi32_ps(v); }
+static inline VecF loadU8AsF(const uint8_t* p) { return toF(loadU8AsI32(p)); }
+static inline VecF loadF(const float* p) { return _mm_loadu_ps(p); }
+static inline void storeF(float* p, VecF v) { _mm_storeu_ps(p, v); }
+static inline VecF setF(float v) { return _mm_set1_ps(v); }
+static inline VecF zeroF() { return _mm_setzero_ps(); }
+static inline VecF addF(VecF a, VecF b) { return _mm_add_ps(a, b); }
+static inline VecF subF(VecF a, VecF b) { return _mm_sub_ps(a, b); }
+static inline VecF mulF(VecF a, VecF b) { return _mm_mul_ps(a, b); }
+static inline VecF divF(VecF a, VecF b) { return _mm_div_ps(a, b); }
+static inline VecF sqrtF(VecF a) { return _mm_sqrt_ps(a); }
+static inline VecF minF(VecF a, VecF b) { return _mm_min_ps(a, b); }
+static inline VecF maxF(VecF a, VecF b) { return _mm_max_ps(a, b); }
+static inline VecF absF(VecF a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline VecF gatherF(const float* table, VecI idx) {
+    alignas(16) int i[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(i), idx);
+    return _mm_setr_ps(table[i[0]], table[i[1]], table[i[2]], table[i[3]]);
+}
+
+static inline void packI32ToU8(uint8_t* p, VecI v) {
+    __m128i w = _mm_packs_epi32(v, v);
+    uint32_t bytes = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(w, w)));
+    for (int k = 0; k < 4; k++) p[k] = static_cast<uint8_t>(bytes >> (8 * k));
+}
+static inline void storeFAsU8(uint8_t* p, VecF v) { packI32ToU8(p, _mm_cvtps_epi32(v)); }
+static inline VecI truncFToI(VecF v) { return _mm_cvttps_epi32(v); }
+static inline void storeI(int* p, VecI v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+static inline void storeFAsU8Trunc(uint8_t* p, VecF v) { packI32ToU8(p, _mm_cvttps_epi32(v)); }
+#endif
+
+// ============== BGR intercalado <-> planos (16 pixels, pshufb) ==============
+
+struct ShuffleMasks {
+    __m128i split[3][3];   // [canal][bloco de entrada]
+    __m128i merge[3][3];   // [bloco de saída][canal]
+
+    ShuffleMasks() {
+        alignas(16) char m[16];
+        for (int c = 0; c < 3; c++) {
+            for (int part = 0; part < 3; part++) {
+                for (int o = 0; o < 16; o++) {
+                    int src = 3 * o + c - 16 * part;
+                    m[o] = (src >= 0 && src < 16) ? static_cast<char>(src) : static_cast<char>(0x80);
+                }
+                split[c][part] = _mm_load_si128(reinterpret_cast<const __m128i*>(m));
+            }
+        }
+        for (int part = 0; part < 3; part++) {
+            for (int c = 0; c < 3; c++) {
+                for (int q = 0; q < 16; q++) {
+                    int g = 16 * part + q;
+                    m[q] = (g % 3 == c) ? static_cast<char>(g / 3) : static_cast<char>(0x80);
+                }
+                merge[part][c] = _mm_load_si128(reinterpret_cast<const __m128i*>(m));
+            }
+        }
+    }
+};
+
+static const ShuffleMasks& shuffleMasks() {
+    static const ShuffleMasks masks;
+    return masks;
+}
+
+static inline void loadBGR16(const uint8_t* p, const ShuffleMasks& m, __m128i& b, __m128i& g, __m128i& r) {
+    __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16));
+    __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32));
+    __m128i* out[3] = {&b, &g, &r};
+    for (int c = 0; c < 3; c++) {
+        *out[c] = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v0, m.split[c][0]),
+                                            _mm_shuffle_epi8(v1, m.split[c][1])),
+                               _mm_shuffle_epi8(v2, m.split[c][2]));
+    }
+}
+
+static inline void storeBGR16(uint8_t* p, const ShuffleMasks& m, __m128i b, __m128i g, __m128i r) {
+    for (int part = 0; part < 3; part++) {
+        __m128i v = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(b, m.merge[part][0]),
+                                              _mm_shuffle_epi8(g, m.merge[part][1])),
+                                 _mm_shuffle_epi8(r, m.merge[part][2]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p + 16 * part), v);
+    }
+}
+
+// Soma ponderada de 3 planos em ponto fixo: (r*wR + g*wG + b*wB) >> shift, saturada em 16 bytes.
+// wRG guarda o par (wR, wG) em cada int32 para _mm_madd_epi16.
+static inline __m128i dot3U8(__m128i b, __m128i g, __m128i r, __m128i wRG, __m128i wB, int shift) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i halves[2];
+    for (int h = 0; h < 2; h++) {
+        __m128i b16 = h == 0 ? _mm_unpacklo_epi8(b, zero) : _mm_unpackhi_epi8(b, zero);
+        __m128i g16 = h == 0 ? _mm_unpacklo_epi8(g, zero) : _mm_unpackhi_epi8(g, zero);
+        __m128i r16 = h == 0 ? _mm_unpacklo_epi8(r, zero) : _mm_unpackhi_epi8(r, zero);
+        __m128i s0 = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(r16, g16), wRG),
+                                   _mm_madd_epi16(_mm_unpacklo_epi16(b16, zero), wB));
+        __m128i s1 = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(r16, g16), wRG),
+                                   _mm_madd_epi16(_mm_unpackhi_epi16(b16, zero), wB));
+        halves[h] = _mm_packs_epi32(_mm_srai_epi32(s0, shift), _mm_srai_epi32(s1, shift));
+    }
+    return _mm_packus_epi16(halves[0], halves[1]);
+}
+
+static inline __m128i packWeights(int wR, int wG) {
+    return _mm_set1_epi32(static_cast<int>((static_cast<unsigned>(wG) << 16) | (wR & 0xFFFF)));
+}
+
+// Pós-operação pontual aplicada em registrador aos 16 bytes de cada canal de saída
+struct NoPost {
+    __m128i operator()(__m128i v) const { return v; }
+};
+
+struct LutPost {
+    const uint8_t* table;
+    __m128i operator()(__m128i v) const {
+        alignas(16) uint8_t bytes[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(bytes), v);
+        for (int k = 0; k < 16; k++) bytes[k] = table[bytes[k]];
+        return _mm_load_si128(reinterpret_cast<const __m128i*>(bytes));
+    }
+};
+
+// x > t  <=>  subs(x, t) != 0 (t em [0, 254])
+struct ThresholdPost {
+    __m128i t;
+    __m128i operator()(__m128i v) const {
+        const __m128i zero = _mm_setzero_si128();
+        return _mm_xor_si128(_mm_cmpeq_epi8(_mm_subs_epu8(v, t), zero), _mm_cmpeq_epi8(zero, zero));
+    }
+};
+
+template <typename Post>
+static int colorMatrixRowImpl(const uint8_t* src, uint8_t* dst, int cols, const int (*w)[3], int out,
+                              int shift, Post post) {
+    const ShuffleMasks& m = shuffleMasks();
+    __m128i wRG[3], wB[3];
+    for (int c = 0; c < out; c++) {
+        wRG[c] = packWeights(w[c][0], w[c][1]);
+        wB[c] = _mm_set1_epi32(w[c][2]);
+    }
+    int j = 0;
+    for (; j + 16 <= cols; j += 16) {
+        __m128i b, g, r;
+        loadBGR16(src + j * 3, m, b, g, r);
+        if (out == 1) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + j), post(dot3U8(b, g, r, wRG[0], wB[0], shift)));
+        } else {
+            storeBGR16(dst + j * 3, m,
+                       post(dot3U8(b, g, r, wRG[0], wB[0], shift)),
+                       post(dot3U8(b, g, r, wRG[1], wB[1], shift)),
+                       post(dot3U8(b, g, r, wRG[2], wB[2], shift)));
+        }
+    }
+    return j;
+}
+
+int colorMatrixRow(const uint8_t* src, uint8_t* dst, int cols, const int (*weights)[3], int outChannels,
+                   int shift, const uint8_t* lut, int threshold) {
+    if (threshold >= 0 && threshold <= 254) {
+        return colorMatrixRowImpl(src, dst, cols, weights, outChannels, shift,
+                                  ThresholdPost{_mm_set1_epi8(static_cast<char>(threshold))});
+    }
+    if (lut) return colorMatrixRowImpl(src, dst, cols, weights, outChannels, shift, LutPost{lut});
+    return colorMatrixRowImpl(src, dst, cols, weights, outChannels, shift, NoPost());
+}
+
+// ============== Convolução ==============
+
+int convolveRow(const uint8_t* const* rows, const Tap* taps, int tapCount, uint8_t* dst, int rowLen) {
+    int j = 0;
+    for (; j + kFLanes <= rowLen; j += kFLanes) {
+        VecF acc = zeroF();
+        for (int t = 0; t < tapCount; t++) {
+            acc = addF(acc, mulF(setF(taps[t].weight), loadU8AsF(rows[taps[t].row] + taps[t].offset + j)));
+        }
+        storeFAsU8(dst + j, acc);
+    }
+    return j;
+}
+
+int separableRowH(const uint8_t* src, float* dst, int rowLen, const float* weights, int k, int cn) {
+    int j = 0;
+    for (; j + kFLanes <= rowLen; j += kFLanes) {
+        VecF acc = zeroF();
+        for (int q = 0; q < k; q++) acc = addF(acc, mulF(setF(weights[q]), loadU8AsF(src + j + q * cn)));
+        storeF(dst + j, acc);
+    }
+    return j;
+}
+
+int separableRowV(const float* const* rows, uint8_t* dst, int rowLen, const float* weights, int k) {
+    int j = 0;
+    for (; j + kFLanes <= rowLen; j += kFLanes) {
+        VecF acc = zeroF();
+        for (int q = 0; q < k; q++) acc = addF(acc, mulF(setF(weights[q]), loadF(rows[q] + j)));
+        storeFAsU8(dst + j, acc);
+    }
+    return j;
+}
+
+// ============== Gradientes ==============
+
+// gx e gy do Sobel 3x3 em kFLanes pixels; inteiros exatos em float
+static inline void sobelVec(const uint8_t* p0, const uint8_t* p1, const uint8_t* p2, int j, VecF& gx, VecF& gy) {
+    const VecF two = setF(2.0f);
+    VecF a00 = loadU8AsF(p0 + j), a01 = loadU8AsF(p0 + j + 1), a02 = loadU8AsF(p0 + j + 2);
+    VecF a10 = loadU8AsF(p1 + j), a12 = loadU8AsF(p1 + j + 2);
+    VecF a20 = loadU8AsF(p2 + j), a21 = loadU8AsF(p2 + j + 1), a22 = loadU8AsF(p2 + j + 2);
+    gx = subF(addF(addF(a02, mulF(two, a12)), a22), addF(addF(a00, mulF(two, a10)), a20));
+    gy = subF(addF(addF(a20, mulF(two, a21)), a22), addF(addF(a00, mulF(two, a01)), a02));
+}
+
+int sobelRow(const uint8_t* p0, const uint8_t* p1, const uint8_t* p2, uint8_t* dst, int cols, Norm norm) {
+    const VecF threeEighths = setF(0.375f);
+    int j = 0;
+    for (; j + kFLanes <= cols; j += kFLanes) {
+        VecF gx, gy;
+        sobelVec(p0, p1, p2, j, gx, gy);
+        VecF magnitude;
+        if (norm == Norm::L2) {
+            magnitude = sqrtF(addF(mulF(gx, gx), mulF(gy, gy)));
+        } else {
+            VecF ax = absF(gx), ay = absF(gy);
+            magnitude = norm == Norm::L1 ? addF(ax, ay) : addF(maxF(ax, ay), mulF(threeEighths, minF(ax, ay)));
+        }
+        storeFAsU8Trunc(dst + j, magnitude);
+    }
+    return j;
+}
+
+int cannyGradientRow(const uint8_t* p0, const uint8_t* p1, const uint8_t* p2, int cols,
+                     int* gx, int* gy, int* magnitude) {
+    int j = 0;
+    for (; j + kFLanes <= cols; j += kFLanes) {
+        VecF x, y;
+        sobelVec(p0, p1, p2, j, x, y);
+        storeI(gx + j, truncFToI(x));
+        storeI(gy + j, truncFToI(y));
+        storeI(magnitude + j, truncFToI(sqrtF(addF(mulF(x, x), mulF(y, y)))));
+    }
+    return j;
+}
+
+// ============== Operações pontuais ==============
+
+int addSaturateRow(uint8_t* row, int len, int value) {
+    const VecU8 bias = setU8(value);
+    int j = 0;
+    for (; j + kU8Lanes <= len; j += kU8Lanes) storeU8(row + j, addsU8(loadU8(row + j), bias));
+    return j;
+}
+
+int invertRow(const uint8_t* src, uint8_t* dst, int len) {
+    const VecU8 ones = setU8(0xFF);
+    int j = 0;
+    for (; j + kU8Lanes <= len; j += kU8Lanes) storeU8(dst + j, xorU8(loadU8(src + j), ones));
+    return j;
+}
+
+// x > t  <=>  subs(x, t) != 0
+int thresholdRow(const uint8_t* src, uint8_t* dst, int len, int threshold) {
+    const VecU8 t = setU8(threshold), zero = setU8(0), ones = setU8(0xFF);
+    int j = 0;
+    for (; j + kU8Lanes <= len; j += kU8Lanes) storeU8(dst + j, xorU8(cmpeqU8(subsU8(loadU8(src + j), t), zero), ones));
+    return j;
+}
+
+#if defined(PAVIC_SIMD_AVX2)
+int lutRow(const uint8_t* src, uint8_t* dst, int len, const int* table) {
+    int j = 0;
+    for (; j + 8 <= len; j += 8) packI32ToU8(dst + j, _mm256_i32gather_epi32(table, loadU8AsI32(src + j), 4));
+    return j;
+}
+#endif
+
+// ============== Bilateral ==============
+
+int bilateralRow(const uint8_t* const* rows, const uint8_t* center, const Tap* taps, int tapCount,
+                 const float* colorLut, uint8_t* dst, int rowLen) {
+    int j = 0;
+    for (; j + kFLanes <= rowLen; j += kFLanes) {
+        VecI c = loadU8AsI32(center + j);
+        VecF sumW = zeroF(), sumV = zeroF();
+        for (int t = 0; t < tapCount; t++) {
+            VecI nb = loadU8AsI32(rows[taps[t].row] + taps[t].offset + j);
+            VecF w = mulF(setF(taps[t].weight), gatherF(colorLut, absDiffI32(c, nb)));
+            sumW = addF(sumW, w);
+            sumV = addF(sumV, mulF(w, toF(nb)));
+        }
+        storeFAsU8(dst + j, divF(sumV, sumW));
+    }
+    return j;
+}
+
+// ============== SAD ==============
+
+uint64_t sumAbsDiffRow(const uint8_t* a, const uint8_t* b, size_t len) {
+    size_t j = 0;
+#if defined(PAVIC_SIMD_AVX2)
+    __m256i acc = _mm256_setzero_si256();
+    for (; j + 32 <= len; j += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + j));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + j));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(va, vb));
+    }
+    __m128i acc128 = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+#else
+    __m128i acc128 = _mm_setzero_si128();
+#endif
+    for (; j + 16 <= len; j += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + j));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+        acc128 = _mm_add_epi64(acc128, _mm_sad_epu8(va, vb));
+    }
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc128);
+    uint64_t sad = lanes[0] + lanes[1];
+    for (; j < len; j++) sad += a[j] > b[j] ? a[j] - b[j] : b[j] - a[j];
+    return sad;
+}
+
+} // namespace kernels
+} // namespace simd
+} // namespace pavic
+
+#endif // PAVIC_SIMD_AVX2 || PAVIC_SIMD_SSE41
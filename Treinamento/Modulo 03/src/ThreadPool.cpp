@@ -0,0 +1,126 @@
+/**
+ * PAVIC LAB 2025 - ThreadPool
+ * Workers persistentes para o backend multithread
+ */
+
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+namespace pavic {
+
+// Os pedaços seguem a divisão de sempre: chunk ou chunk + 1 itens, os maiores primeiro
+struct ThreadPool::Job {
+    const std::function<void(int, int)>* body = nullptr;
+    int chunks = 0;
+    int chunk = 0;
+    int remainder = 0;
+    int helpers = 0;                 // workers que ainda podem entrar (protegido pela trava do pool)
+    std::atomic<int> next{0};        // próximo pedaço a distribuir
+    std::atomic<int> done{0};        // pedaços terminados
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr error;        // primeira exceção de body (protegida por mutex)
+};
+
+ThreadPool::ThreadPool(int workerCount) {
+    if (workerCount <= 0) {
+        unsigned int hc = std::thread::hardware_concurrency();
+        workerCount = hc > 1 ? static_cast<int>(hc) - 1 : 0;
+    }
+    workers.reserve(workerCount);
+    for (int i = 0; i < workerCount; i++) {
+        workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& t : workers) t.join();
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool;
+    return pool;
+}
+
+bool ThreadPool::runChunk(Job& job) {
+    int i = job.next.fetch_add(1);
+    if (i >= job.chunks) return false;
+
+    int start = i * job.chunk + std::min(i, job.remainder);
+    int end = start + job.chunk + (i < job.remainder ? 1 : 0);
+    try {
+        (*job.body)(start, end);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(job.mutex);
+        if (!job.error) job.error = std::current_exception();
+    }
+    if (job.done.fetch_add(1) + 1 == job.chunks) {
+        std::lock_guard<std::mutex> lock(job.mutex);
+        job.finished.notify_all();
+    }
+    return true;
+}
+
+void ThreadPool::workerLoop() {
+    for (;;) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (stopping) return;
+            job = queue.front();
+            // Sem vagas ou sem pedaços a distribuir: o job sai da fila e o worker procura outro
+            if (job->helpers == 0 || job->next.load() >= job->chunks) {
+                queue.pop_front();
+                continue;
+            }
+            if (--job->helpers == 0) queue.pop_front();
+        }
+        while (runChunk(*job)) {}
+    }
+}
+
+void ThreadPool::parallelFor(int count, int maxThreads, int grain, const std::function<void(int, int)>& body) {
+    if (count <= 0) return;
+    if (maxThreads <= 0) maxThreads = getWorkerCount() + 1;
+    int chunks = std::min(maxThreads, (count + std::max(grain, 1) - 1) / std::max(grain, 1));
+    if (chunks <= 1 || workers.empty()) {
+        body(0, count);
+        return;
+    }
+
+    auto job = std::make_shared<Job>();
+    job->body = &body;
+    job->chunks = chunks;
+    job->chunk = count / chunks;
+    job->remainder = count % chunks;
+    job->helpers = std::min(chunks - 1, getWorkerCount());
+    const int helpers = job->helpers;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(job);
+    }
+    for (int i = 0; i < helpers; i++) wake.notify_one();
+
+    // A thread que chama também processa; quando os pedaços acabam, só falta esperar os que estão em curso
+    while (runChunk(*job)) {}
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = std::find(queue.begin(), queue.end(), job);
+        if (it != queue.end()) queue.erase(it);
+    }
+    {
+        std::unique_lock<std::mutex> lock(job->mutex);
+        job->finished.wait(lock, [&] { return job->done.load() == job->chunks; });
+    }
+    if (job->error) std::rethrow_exception(job->error);
+}
+
+} // namespace pavic
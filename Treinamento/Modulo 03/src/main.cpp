@@ -2,7 +2,7 @@
  * PAVIC LAB 2025 - Processamento de Imagens GPU vs CPU
  * 
  * Funcionalidades:
- * - Comparação Sequential, Parallel (OpenMP), Multithread, CUDA
+ * - Comparação Sequential, Parallel (OpenMP), Multithread, CUDA, SIMD (SSE4.1/AVX2)
  * - Benchmark comparativo mostrando todos os tempos e speedups
  * - Processamento de webcam em tempo real com FPS
  * - Diálogo nativo para seleção de arquivos
@@ -10,13 +10,16 @@
  * Teclas:
  * - 1-9, 0, B: Selecionar filtro
  * - M: Alternar modo de processamento
+ * - P: Alternar precisão (Double, Float32, Ponto fixo)
  * - O: Abrir imagem ou câmera
  * - S: Salvar resultado
- * - C: Benchmark Comparativo (roda nos 4 modos)
+ * - C: Benchmark Comparativo (roda em todos os modos)
  * - Q/ESC: Sair
  */
 
 #include "ImageProcessor.h"
+#include "IncrementalProcessor.h"
+#include "BufferPool.h"
 #include "PerformanceMetrics.h"
 
 #include <opencv2/opencv.hpp>
@@ -101,16 +104,21 @@ struct BenchmarkResult {
     double timeParallel = 0;
     double timeMultithread = 0;
     double timeCUDA = 0;
+    double timeSIMD = 0;
+    double timeSIMDThreads = 0;
     bool hasResults = false;
 };
 
 struct State {
     FilterType filter = FilterType::GRAYSCALE;
     ProcessingType proc = ProcessingType::SEQUENTIAL;
+    Precision precision = Precision::DOUBLE;
     ProcessingResult last{};
     BenchmarkResult benchmark;
     bool usingCamera = false;
     cv::VideoCapture camera;
+    bool incremental = true;        // câmera: recalcular só os tiles que mudaram
+    double recomputeRatio = 1.0;
     
     // FPS tracking
     int frameCount = 0;
@@ -173,7 +181,8 @@ static void drawSideBySide(const cv::Mat& left, const cv::Mat& right, const Stat
     
     if (s.last.success) {
         char timeStr[32];
-        snprintf(timeStr, sizeof(timeStr), "%.2f ms", s.last.executionTimeMs);
+        snprintf(timeStr, sizeof(timeStr), s.last.fromCache ? "%.2f ms (cache)" : "%.2f ms",
+                 s.last.executionTimeMs);
         drawText(canvas, timeStr, {gap + 550, 22}, 0.55, {0, 255, 255}, 2);
     }
     
@@ -184,6 +193,11 @@ static void drawSideBySide(const cv::Mat& left, const cv::Mat& right, const Stat
         cv::Scalar fpsColor = s.fps >= 25 ? cv::Scalar(0, 255, 0) : 
                               (s.fps >= 15 ? cv::Scalar(0, 255, 255) : cv::Scalar(0, 0, 255));
         drawText(canvas, fpsStr, {gap + 680, 22}, 0.6, fpsColor, 2);
+        if (s.incremental) {
+            char ratioStr[32];
+            snprintf(ratioStr, sizeof(ratioStr), "Recalc: %.0f%%", s.recomputeRatio * 100.0);
+            drawText(canvas, ratioStr, {gap + 800, 22}, 0.5, {200, 200, 200}, 1);
+        }
     }
     
     // Labels das imagens
@@ -203,7 +217,7 @@ static void drawSideBySide(const cv::Mat& left, const cv::Mat& right, const Stat
     drawText(canvas, "[C] para executar", {benchX + 55, headerH + 48}, 0.4, {150, 150, 150}, 1, false);
     
     int yPos = headerH + 75;
-    int spacing = 62;
+    int spacing = 46;
     
     // Sequential
     drawText(canvas, "SEQUENTIAL (CPU)", {benchX + 10, yPos}, 0.45, {100, 150, 255}, 1, false);
@@ -257,6 +271,34 @@ static void drawSideBySide(const cv::Mat& left, const cv::Mat& right, const Stat
         drawText(canvas, "-- ms", {benchX + 10, yPos + 20}, 0.5, {100, 100, 100}, 1, false);
     }
     
+    yPos += spacing;
+    
+    // SIMD
+    drawText(canvas, "SIMD (SSE4.1/AVX2)", {benchX + 10, yPos}, 0.45, {255, 180, 220}, 1, false);
+    if (s.benchmark.hasResults) {
+        char buf[64];
+        double speedup = s.benchmark.timeSequential / s.benchmark.timeSIMD;
+        snprintf(buf, sizeof(buf), "%.2f ms (%.1fx)", s.benchmark.timeSIMD, speedup);
+        cv::Scalar col = speedup > 1 ? cv::Scalar(255, 255, 0) : cv::Scalar(0, 0, 255);
+        drawText(canvas, buf, {benchX + 10, yPos + 20}, 0.5, col, 1, false);
+    } else {
+        drawText(canvas, "-- ms", {benchX + 10, yPos + 20}, 0.5, {100, 100, 100}, 1, false);
+    }
+    
+    yPos += spacing;
+    
+    // SIMD + threads
+    drawText(canvas, "SIMD + THREADS", {benchX + 10, yPos}, 0.45, {200, 140, 255}, 1, false);
+    if (s.benchmark.hasResults) {
+        char buf[64];
+        double speedup = s.benchmark.timeSequential / s.benchmark.timeSIMDThreads;
+        snprintf(buf, sizeof(buf), "%.2f ms (%.1fx)", s.benchmark.timeSIMDThreads, speedup);
+        cv::Scalar col = speedup > 1 ? cv::Scalar(255, 255, 0) : cv::Scalar(0, 0, 255);
+        drawText(canvas, buf, {benchX + 10, yPos + 20}, 0.5, col, 1, false);
+    } else {
+        drawText(canvas, "-- ms", {benchX + 10, yPos + 20}, 0.5, {100, 100, 100}, 1, false);
+    }
+    
     // Footer - teclas de atalho
     int footerY = headerH + imgH + 22;
     drawText(canvas, "[1-9,0,B] Filtros", {gap, footerY}, 0.4, {180, 180, 180}, 1, false);
@@ -265,6 +307,8 @@ static void drawSideBySide(const cv::Mat& left, const cv::Mat& right, const Stat
     drawText(canvas, "[O] Abrir", {gap + 410, footerY}, 0.4, {180, 180, 180}, 1, false);
     drawText(canvas, "[S] Salvar", {gap + 520, footerY}, 0.4, {180, 180, 180}, 1, false);
     drawText(canvas, "[Q] Sair", {gap + 630, footerY}, 0.4, {180, 180, 180}, 1, false);
+    drawText(canvas, "[P] Precisao: " + utils::getPrecisionName(s.precision), {gap + 730, footerY}, 0.4, {180, 180, 180}, 1, false);
+    drawText(canvas, std::string("[I] Incremental: ") + (s.incremental ? "ON" : "OFF"), {gap + 930, footerY}, 0.4, {180, 180, 180}, 1, false);
     
     cv::imshow("PAVIC LAB 2025", canvas);
 }
@@ -296,44 +340,70 @@ void runComparativeBenchmark(ImageProcessor& proc, State& s) {
               << proc.getOriginalImage().rows << std::endl;
     std::cout << "----------------------------" << std::endl;
     
+    // Sem cache de resultados: cada backend processa de fato
     // Sequential
-    auto result = proc.applyFilter(s.filter, ProcessingType::SEQUENTIAL);
+    auto result = proc.applyFilter(s.filter, ProcessingType::SEQUENTIAL, false);
     s.benchmark.timeSequential = result.executionTimeMs;
     std::cout << "Sequential:  " << std::fixed << std::setprecision(2) 
               << s.benchmark.timeSequential << " ms" << std::endl;
     
     // Parallel
-    result = proc.applyFilter(s.filter, ProcessingType::PARALLEL);
+    result = proc.applyFilter(s.filter, ProcessingType::PARALLEL, false);
     s.benchmark.timeParallel = result.executionTimeMs;
     std::cout << "Parallel:    " << s.benchmark.timeParallel << " ms ("
               << std::setprecision(1) << (s.benchmark.timeSequential / s.benchmark.timeParallel) 
               << "x)" << std::endl;
     
     // Multithread
-    result = proc.applyFilter(s.filter, ProcessingType::MULTITHREAD);
+    result = proc.applyFilter(s.filter, ProcessingType::MULTITHREAD, false);
     s.benchmark.timeMultithread = result.executionTimeMs;
     std::cout << "Multithread: " << std::setprecision(2) << s.benchmark.timeMultithread << " ms ("
               << std::setprecision(1) << (s.benchmark.timeSequential / s.benchmark.timeMultithread) 
               << "x)" << std::endl;
     
     // CUDA
-    result = proc.applyFilter(s.filter, ProcessingType::CUDA);
+    result = proc.applyFilter(s.filter, ProcessingType::CUDA, false);
     s.benchmark.timeCUDA = result.executionTimeMs;
     s.last = result; // Mostrar resultado CUDA
     std::cout << "CUDA:        " << std::setprecision(2) << s.benchmark.timeCUDA << " ms ("
               << std::setprecision(1) << (s.benchmark.timeSequential / s.benchmark.timeCUDA) 
               << "x)" << std::endl;
     
+    // SIMD
+    result = proc.applyFilter(s.filter, ProcessingType::SIMD, false);
+    s.benchmark.timeSIMD = result.executionTimeMs;
+    std::cout << "SIMD:        " << std::setprecision(2) << s.benchmark.timeSIMD << " ms ("
+              << std::setprecision(1) << (s.benchmark.timeSequential / s.benchmark.timeSIMD) 
+              << "x)" << std::endl;
+    
+    // SIMD + threads
+    result = proc.applyFilter(s.filter, ProcessingType::SIMD_MULTITHREAD, false);
+    s.benchmark.timeSIMDThreads = result.executionTimeMs;
+    std::cout << "SIMD+Threads:" << std::setprecision(2) << s.benchmark.timeSIMDThreads << " ms ("
+              << std::setprecision(1) << (s.benchmark.timeSequential / s.benchmark.timeSIMDThreads) 
+              << "x)" << std::endl;
+    
     s.benchmark.hasResults = true;
     std::cout << "==============================\n" << std::endl;
 }
 
+static Precision nextPrecision(Precision p) {
+    switch (p) {
+        case Precision::DOUBLE: return Precision::FLOAT32;
+        case Precision::FLOAT32: return Precision::FIXED_POINT;
+        case Precision::FIXED_POINT: return Precision::DOUBLE;
+    }
+    return Precision::DOUBLE;
+}
+
 static ProcessingType nextProc(ProcessingType p) {
     switch (p) {
         case ProcessingType::SEQUENTIAL: return ProcessingType::PARALLEL;
         case ProcessingType::PARALLEL: return ProcessingType::MULTITHREAD;
         case ProcessingType::MULTITHREAD: return ProcessingType::CUDA;
-        case ProcessingType::CUDA: return ProcessingType::SEQUENTIAL;
+        case ProcessingType::CUDA: return ProcessingType::SIMD;
+        case ProcessingType::SIMD: return ProcessingType::SIMD_MULTITHREAD;
+        case ProcessingType::SIMD_MULTITHREAD: return ProcessingType::SEQUENTIAL;
     }
     return ProcessingType::SEQUENTIAL;
 }
@@ -351,9 +421,15 @@ int main(int argc, char** argv) {
         }
     }
 
+    // Saídas e intermediários dos filtros reciclam os buffers dos quadros anteriores
+    BufferPool::global().install();
+
     ImageProcessor proc;
+    IncrementalProcessor incremental;
+    proc.setResultCacheBudget(512u << 20);  // voltar a um filtro já visto na mesma imagem é imediato
     State state;
     cv::Mat original;
+    cv::Mat frameOutput;  // saída da câmera, reaproveitada quadro a quadro
     
     // Inicializar com argumento de linha de comando
     if (!imgPath.empty()) {
@@ -391,7 +467,13 @@ int main(int argc, char** argv) {
             state.camera >> original;
             if (!original.empty()) {
                 proc.loadImage(original);
-                state.last = proc.applyFilter(state.filter, state.proc);
+                if (state.incremental) {
+                    state.last = incremental.processFrame(original, state.filter, state.proc);
+                    state.recomputeRatio = incremental.getStats().recomputeRatio;
+                } else {
+                    // Frames não se repetem: sem cache, direto no buffer de saída do quadro anterior
+                    state.last = proc.processFrame(original, state.filter, state.proc, frameOutput);
+                }
                 
                 // Calcular FPS
                 state.frameCount++;
@@ -414,6 +496,14 @@ int main(int argc, char** argv) {
         if (key == 'm' || key == 'M') {
             state.proc = nextProc(state.proc);
             state.benchmark.hasResults = false; // Reset benchmark ao mudar modo
+        } else if (key == 'p' || key == 'P') {
+            state.precision = nextPrecision(state.precision);
+            proc.setPrecision(state.precision);
+            incremental.setPrecision(state.precision);
+            state.benchmark.hasResults = false;
+        } else if (key == 'i' || key == 'I') {
+            state.incremental = !state.incremental;
+            incremental.reset();
         } else if (key == 'c' || key == 'C') {
             // Benchmark comparativo
             if (!proc.getOriginalImage().empty()) {